@@ -0,0 +1,292 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "batch.h"
+#include "helpers.h"
+#include "console.h"
+#include "lanes.h"
+
+// State shared by the jobs of one batch
+struct BatchShared {
+    const struct HunterEntry* roster;
+    int hunter_count;
+    int runs;
+    unsigned long long seed; // Master seed of the batch
+    enum SimEngine engine; // Engine of every run
+    int workers; // Pool workers of every run
+    const struct Layout* layout; // Room graph of every house
+    _Atomic int next_run; // Next run index a job may claim
+    pthread_mutex_t lock; // Guards stats
+    struct BatchStats* stats;
+};
+
+// Position of a ghost type in get_all_ghost_types()
+static int ghost_index(enum GhostType type) {
+    int index = ghost_deduce((EvidenceByte)type)->exact;
+    return index < BATCH_MAX_GHOST_TYPES ? index : -1;
+}
+
+// Fold the outcome of one run into the totals
+static void batch_record(struct BatchShared* shared, const struct LaneOutcome* outcome) {
+    int moves = outcome->hunter_moves + outcome->ghost_moves;
+    int ghost = ghost_index(outcome->ghost);
+
+    pthread_mutex_lock(&shared->lock);
+    struct BatchStats* stats = shared->stats;
+    if (stats->runs == 0 || moves < stats->min_moves) stats->min_moves = moves;
+    if (stats->runs == 0 || moves > stats->max_moves) stats->max_moves = moves;
+    stats->runs++;
+    stats->hunter_wins += outcome->hunters_win;
+    for (int i = 0; i < 3; i++) stats->exit_reasons[i] += outcome->exit_reasons[i];
+    stats->hunter_moves += outcome->hunter_moves;
+    stats->ghost_moves += outcome->ghost_moves;
+    if (ghost >= 0) {
+        stats->ghost_runs[ghost]++;
+        stats->ghost_wins[ghost] += outcome->hunters_win;
+    }
+    pthread_mutex_unlock(&shared->lock);
+}
+
+// Outcome of the finished run of a house
+static void house_outcome(const struct House* house, struct LaneOutcome* outcome) {
+    memset(outcome, 0, sizeof(*outcome));
+    outcome->ghost = house->ghost.ghostType;
+    outcome->ghost_moves = house->ghost.moves;
+
+    for (int i = 0; i < house->hunterCount; i++) {
+        const struct Hunter* h = &house->hunter[i];
+        outcome->hunter_moves += h->moves;
+        if (h->whyExit >= LR_EVIDENCE && h->whyExit <= LR_AFRAID) outcome->exit_reasons[h->whyExit]++;
+        if (h->whyExit == LR_EVIDENCE) outcome->hunters_win = true;
+    }
+}
+
+// Lanes job: claim LANES_WIDTH runs at a time and advance them together
+static void batch_lanes_job(struct BatchShared* shared) {
+    struct House house;
+    memset(&house, 0, sizeof(house));
+    house_build_layout(&house, shared->layout);
+
+    struct LaneMap map;
+    lanes_map_init(&map, &house); // The caller checked that the layout fits
+
+    for (;;) {
+        int first = atomic_fetch_add(&shared->next_run, LANES_WIDTH);
+        if (first >= shared->runs) break;
+
+        int lanes = shared->runs - first < LANES_WIDTH ? shared->runs - first : LANES_WIDTH;
+        uint64_t seeds[LANES_WIDTH];
+        for (int i = 0; i < lanes; i++) {
+            seeds[i] = rng_derive(shared->seed, RNG_STREAM_RUN, first + i);
+        }
+
+        struct LaneOutcome outcomes[LANES_WIDTH];
+        lanes_simulate(&map, shared->hunter_count, seeds, lanes, outcomes);
+        for (int i = 0; i < lanes; i++) {
+            batch_record(shared, &outcomes[i]);
+        }
+    }
+
+    house_free_layout(&house);
+}
+
+// One job: build a house once, then claim and run simulations until none are left
+static void* batch_job(void* arg) {
+    struct BatchShared* shared = arg;
+    bool built = false;
+
+    if (shared->engine == ENGINE_LANES) {
+        batch_lanes_job(shared);
+        return NULL;
+    }
+
+    struct House house;
+    memset(&house, 0, sizeof(house));
+
+    for (;;) {
+        int run = atomic_fetch_add(&shared->next_run, 1);
+        if (run >= shared->runs) break;
+
+        // Every run gets its own seed, whichever job ends up running it
+        house.seed = rng_derive(shared->seed, RNG_STREAM_RUN, run);
+
+        if (!built) {
+            // Same setup as a single run; the first run uses it directly
+            house_build_layout(&house, shared->layout);
+            house.engine = shared->engine;
+            house.workers = shared->workers;
+            casefile_init(&house.fileCase);
+            ghost_init(&house.ghost, &house);
+            house_add_roster(&house, shared->roster, shared->hunter_count);
+            built = true;
+        } else {
+            house_reset(&house);
+        }
+
+        house_simulate(&house);
+
+        struct LaneOutcome outcome;
+        house_outcome(&house, &outcome);
+        batch_record(shared, &outcome);
+    }
+
+    if (built) {
+        house_cleanup(&house);
+    }
+    return NULL;
+}
+
+struct HunterEntry* roster_generate(int count) {
+    struct HunterEntry* roster = malloc((count > 0 ? count : 1) * sizeof(struct HunterEntry));
+    for (int i = 0; i < count; i++) {
+        snprintf(roster[i].name, sizeof(roster[i].name), "hunter%d", i + 1);
+        roster[i].id = i + 1;
+    }
+    return roster;
+}
+
+struct HunterEntry* roster_load(const char* path, int* count) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return NULL;
+    }
+
+    struct HunterEntry* roster = NULL;
+    int capacity = 0;
+    char line[256];
+    int number = 0;
+    *count = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        number++;
+        if (!strchr(line, '\n') && !feof(file)) {
+            fprintf(stderr, "%s:%d: line too long\n", path, number);
+            free(roster);
+            fclose(file);
+            return NULL;
+        }
+
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        char name[MAX_HUNTER_NAME];
+        int id;
+        char extra;
+        int fields = sscanf(line, "%63s %d %c", name, &id, &extra);
+        if (fields == EOF) continue; // Blank or comment only
+        if (fields != 2) {
+            fprintf(stderr, "%s:%d: expected \"NAME ID\"\n", path, number);
+            free(roster);
+            fclose(file);
+            return NULL;
+        }
+
+        if (*count == capacity) {
+            capacity = (capacity == 0 ? 64 : capacity * 2);
+            roster = realloc(roster, capacity * sizeof(struct HunterEntry));
+        }
+        strcpy(roster[*count].name, name);
+        roster[*count].id = id;
+        (*count)++;
+    }
+    fclose(file);
+
+    // An empty file is a valid, empty roster
+    return roster ? roster : malloc(sizeof(struct HunterEntry));
+}
+
+void house_add_roster(struct House* house, const struct HunterEntry* roster, int count) {
+    house_reserve_hunters(house, house->hunterCount + count);
+    for (int i = 0; i < count; i++) {
+        hunter_add(house, roster[i].name, roster[i].id);
+    }
+}
+
+void batch_run(const struct HunterEntry* roster, int hunter_count, int runs, int jobs,
+               unsigned long long seed, enum SimEngine engine, int workers, const struct Layout* layout,
+               struct BatchStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->seed = seed;
+
+    struct BatchShared shared = {
+        .roster = roster,
+        .hunter_count = hunter_count,
+        .runs = runs,
+        .seed = seed,
+        .engine = engine,
+        .workers = workers,
+        .layout = layout ? layout : layout_willow(),
+        .stats = stats
+    };
+    atomic_init(&shared.next_run, 0);
+    pthread_mutex_init(&shared.lock, NULL);
+
+    if (jobs < 1) jobs = 1;
+    if (jobs > runs) jobs = runs;
+    if (engine == ENGINE_LANES) {
+        int groups = (runs + LANES_WIDTH - 1) / LANES_WIDTH;
+        if (jobs > groups) jobs = groups;
+    }
+
+    if (jobs <= 1) {
+        batch_job(&shared); // Back-to-back on the calling thread
+    } else {
+        pthread_t* threads = malloc(sizeof(pthread_t) * jobs);
+        for (int i = 0; i < jobs; i++) {
+            pthread_create(&threads[i], NULL, batch_job, &shared);
+        }
+        for (int i = 0; i < jobs; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        free(threads);
+    }
+
+    pthread_mutex_destroy(&shared.lock);
+}
+
+void batch_print(const struct BatchStats* stats) {
+    int runs = stats->runs > 0 ? stats->runs : 1; // Avoid dividing by zero in the averages
+    int exits = stats->exit_reasons[LR_EVIDENCE] + stats->exit_reasons[LR_BORED] + stats->exit_reasons[LR_AFRAID];
+    if (exits == 0) exits = 1;
+
+    console_summary(
+        "\n"
+        "\033[35m"
+        "=========================\n"
+        "||   BATCH RESULTS!    ||\n"
+        "=========================\n"
+        "\033[0m"
+        "\n"
+    );
+
+    console_summary("- Runs: %d\n", stats->runs);
+    console_summary("- Seed: %llu\n", stats->seed);
+    console_summary("- Hunters win: %d (%.1f%%)\n", stats->hunter_wins, 100.0 * stats->hunter_wins / runs);
+    console_summary("- Ghost wins: %d (%.1f%%)\n", stats->runs - stats->hunter_wins,
+                    100.0 * (stats->runs - stats->hunter_wins) / runs);
+
+    console_summary("\nHunter exit reasons:\n");
+    for (int reason = LR_EVIDENCE; reason <= LR_AFRAID; reason++) {
+        console_summary(" - %-8s %d (%.1f%%)\n", exit_reason_to_string((enum LogReason)reason),
+                        stats->exit_reasons[reason], 100.0 * stats->exit_reasons[reason] / exits);
+    }
+
+    console_summary("\nMoves per run:\n");
+    console_summary(" - hunters  %.1f avg\n", (double)stats->hunter_moves / runs);
+    console_summary(" - ghost    %.1f avg\n", (double)stats->ghost_moves / runs);
+    console_summary(" - total    %.1f avg, %d min, %d max\n",
+                    (double)(stats->hunter_moves + stats->ghost_moves) / runs, stats->min_moves, stats->max_moves);
+
+    console_summary("\nHunter win rate per ghost type:\n");
+    const enum GhostType* types;
+    int count = get_all_ghost_types(&types);
+    for (int i = 0; i < count && i < BATCH_MAX_GHOST_TYPES; i++) {
+        if (stats->ghost_runs[i] == 0) continue;
+        console_summary(" - %-12s %5d/%-5d (%.1f%%)\n", ghost_to_string(types[i]),
+                        stats->ghost_wins[i], stats->ghost_runs[i],
+                        100.0 * stats->ghost_wins[i] / stats->ghost_runs[i]);
+    }
+}
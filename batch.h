@@ -0,0 +1,80 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "defs.h"
+#include "layout.h"
+
+// Highest number of ghost types tracked by the batch statistics
+#define BATCH_MAX_GHOST_TYPES 32
+
+// One hunter of the roster every batch run starts with
+struct HunterEntry {
+    char name[MAX_HUNTER_NAME]; // Hunter name
+    int id; // Hunter ID
+};
+
+// Outcome totals over every run of a batch
+struct BatchStats {
+    unsigned long long seed; // Master seed the run seeds were derived from
+    int runs; // Simulations completed
+    int hunter_wins; // Runs where at least one hunter left with the evidence
+    int exit_reasons[3]; // Hunter exits per enum LogReason
+    long long hunter_moves; // Hunter room changes over all runs
+    long long ghost_moves; // Ghost room changes over all runs
+    int min_moves; // Fewest room changes (hunters and ghost) in one run
+    int max_moves; // Most room changes (hunters and ghost) in one run
+    int ghost_runs[BATCH_MAX_GHOST_TYPES]; // Runs per ghost type (get_all_ghost_types order)
+    int ghost_wins[BATCH_MAX_GHOST_TYPES]; // Hunter wins per ghost type
+};
+
+/**
+ * @brief Make a roster of generated hunters.
+ * @param[in] count Hunters to generate.
+ * @return count entries named hunter1..hunterN with IDs 1..N, in one allocation; free() it.
+ */
+struct HunterEntry* roster_generate(int count);
+
+/**
+ * @brief Read a roster file.
+ * @param[in] path File with one "NAME ID" hunter per line; '#' starts a comment.
+ * @param[out] count Number of entries read.
+ * @return The entries (free() them), or NULL after printing the offending line to stderr.
+ */
+struct HunterEntry* roster_load(const char* path, int* count);
+
+/**
+ * @brief Add every hunter of a roster to a house.
+ * @param[in,out] house House with its rooms built.
+ * @param[in] roster Hunters to add, in order.
+ * @param[in] count Number of entries in roster.
+ *
+ * The hunter array is sized once for the whole roster before any hunter
+ * enters a room, so adding N hunters is one allocation and a linear pass.
+ */
+void house_add_roster(struct House* house, const struct HunterEntry* roster, int count);
+
+/**
+ * @brief Run many independent simulations with the same hunters.
+ * @param[in] roster Hunters placed in the house at the start of every run.
+ * @param[in] hunter_count Number of entries in roster.
+ * @param[in] runs Number of simulations.
+ * @param[in] jobs Simulations run at the same time, each in its own house.
+ * @param[in] seed Master seed; run i uses rng_derive(seed, RNG_STREAM_RUN, i).
+ * @param[in] engine How each run executes its agents.
+ * @param[in] workers Worker threads per run for ENGINE_POOL (0 = one per core).
+ * @param[in] layout Room graph of every house (NULL = Willow); ENGINE_LANES needs one lanes_map_init() accepts.
+ * @param[out] stats Aggregated outcomes.
+ *
+ * Each job builds its house once and resets it in place between runs.
+ */
+void batch_run(const struct HunterEntry* roster, int hunter_count, int runs, int jobs,
+               unsigned long long seed, enum SimEngine engine, int workers, const struct Layout* layout,
+               struct BatchStats* stats);
+
+/**
+ * @brief Print the aggregated outcomes of a batch (summary verbosity).
+ * @param[in] stats Totals returned by batch_run().
+ */
+void batch_print(const struct BatchStats* stats);
+
+#endif // BATCH_H
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "console.h"
+
+static enum ConsoleVerbosity console_level = CONSOLE_FULL;
+
+// Event lines waiting to be written by this thread
+static _Thread_local char console_buffer[CONSOLE_BUFFER_SIZE];
+static _Thread_local size_t console_length = 0;
+
+void console_set_verbosity(enum ConsoleVerbosity level) {
+    console_level = level;
+}
+
+bool console_enabled(enum ConsoleVerbosity level) {
+    return console_level >= level;
+}
+
+void console_flush_thread(void) {
+    if (console_length > 0) {
+        fwrite(console_buffer, 1, console_length, stdout); // One stdout lock per batch
+        console_length = 0;
+    }
+}
+
+void console_event(const char* format, ...) {
+    if (console_level < CONSOLE_FULL) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(console_buffer + console_length, CONSOLE_BUFFER_SIZE - console_length, format, args);
+    va_end(args);
+
+    if (length < 0) {
+        return;
+    }
+
+    if (console_length + (size_t)length >= CONSOLE_BUFFER_SIZE) {
+        // Did not fit: write what is pending, then format again at the start
+        console_flush_thread();
+
+        va_start(args, format);
+        length = vsnprintf(console_buffer, CONSOLE_BUFFER_SIZE, format, args);
+        va_end(args);
+
+        if (length < 0) {
+            return;
+        }
+        if ((size_t)length >= CONSOLE_BUFFER_SIZE) {
+            length = CONSOLE_BUFFER_SIZE - 1; // Cut oversized lines
+        }
+    }
+
+    console_length += (size_t)length;
+}
+
+void console_summary(const char* format, ...) {
+    if (console_level < CONSOLE_SUMMARY) {
+        return;
+    }
+
+    console_flush_thread();
+
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
@@ -0,0 +1,52 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdbool.h>
+
+// Bytes of per-event console text each thread collects before writing it out
+#define CONSOLE_BUFFER_SIZE 8192
+
+// How much the simulation prints to stdout
+enum ConsoleVerbosity {
+    CONSOLE_SILENT = 0, // Nothing
+    CONSOLE_SUMMARY,    // Banner, prompts and the final results
+    CONSOLE_FULL        // Everything, including one line per logged event
+};
+
+/**
+ * @brief Select the console verbosity.
+ * @param[in] level New verbosity; set before any agent thread starts.
+ */
+void console_set_verbosity(enum ConsoleVerbosity level);
+
+/**
+ * @brief Check whether output of a given level is printed.
+ * @param[in] level Verbosity the output belongs to.
+ * @return true when the current verbosity includes level.
+ */
+bool console_enabled(enum ConsoleVerbosity level);
+
+/**
+ * @brief Print one per-event line (CONSOLE_FULL only).
+ * @param[in] format printf-style format.
+ *
+ * The text is collected in a buffer owned by the calling thread and written
+ * in large chunks; below CONSOLE_FULL the call returns before formatting.
+ */
+void console_event(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Print summary output (CONSOLE_SUMMARY and above) immediately.
+ * @param[in] format printf-style format.
+ *
+ * Pending event lines of the calling thread are written first so the
+ * output keeps its order.
+ */
+void console_summary(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+/**
+ * @brief Write out the calling thread's pending event lines.
+ */
+void console_flush_thread(void);
+
+#endif // CONSOLE_H
@@ -2,17 +2,26 @@
 #define DEFS_H
 
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <semaphore.h>
 #include <pthread.h>
+#include "rng.h"
 
 #define MAX_ROOM_NAME 64
 #define MAX_HUNTER_NAME 64
-#define MAX_ROOMS 24
-#define MAX_ROOM_OCCUPANCY 8
-#define MAX_CONNECTIONS 8
+#define ROOM_OCCUPANCY_INITIAL 8 // Occupant slots a room allocates first; grows by doubling
+#define ROUTES_ALL_PAIRS_MAX 256 // Largest house that gets the all-pairs route tables
 #define ENTITY_BOREDOM_MAX 15
 #define HUNTER_FEAR_MAX 15
 #define DEFAULT_GHOST_ID 68057
+#define CACHE_LINE 64
+
+// Cache-aware layout (make CACHE_ALIGN=1): state written by one thread starts its own cache line
+#ifdef CACHE_ALIGN_LAYOUT
+#define CACHE_ALIGNED _Alignas(CACHE_LINE)
+#else
+#define CACHE_ALIGNED
+#endif
 
 //Evidence stored as bitmasks
 typedef unsigned char EvidenceByte; 
@@ -24,6 +33,15 @@ enum LogReason {
     LR_AFRAID = 2
 };
 
+// How the agents of a run are executed
+enum SimEngine {
+    ENGINE_THREADS = 0, // One thread per agent, rooms and case file guarded by semaphores
+    ENGINE_EVENTS,      // Discrete-event scheduler on the calling thread, no locking
+    ENGINE_POOL,        // Fixed pool of work-stealing workers stepping the agents, semaphores as for threads
+    ENGINE_SOA,         // Lockstep ticks on the calling thread over structure-of-arrays hunters, no locking
+    ENGINE_LANES        // Batch only: LANES_WIDTH houses advanced together in SIMD lanes, no logs
+};
+
 // Individual evidence types
 enum EvidenceType {
     EV_EMF          = 1 << 0,
@@ -63,43 +81,47 @@ enum GhostType {
     GH_SPIRIT       = EV_WRITING      | EV_RADIO       | EV_EMF,
 };
 
-// Shared evidence gathered by all hunters
+// Shared evidence gathered by all hunters, alone on its cache line so hunter writes elsewhere never evict it
 struct CaseFile {
-    EvidenceByte collected; // Union of all of the evidence bits collected between all hunters
-    bool         solved;    // True when >=3 unique bits set
-    sem_t        mutex;     // Used for synchronizing both fields when multithreading
+    _Alignas(CACHE_LINE) _Atomic EvidenceByte collected; // Union of all of the evidence bits collected between all hunters
+};
+
+// Hunters inside a room, unordered so insert and remove are O(1)
+struct Occupancy {
+    int* hunters; // Indices into house->hunter
+    int count; // Hunters inside
+    int capacity; // Allocated slots
 };
 
 // Room data structure
 struct Room {
     char name[MAX_ROOM_NAME]; //Room name
+    int index; // Position in house->rooms (used by the logs)
 
-    struct Room* connected[MAX_CONNECTIONS]; // Adjacent rooms
+    const int* connected; // Indices of adjacent rooms, this room's row of house->adjacency
     int connectionCount; // Number of connections
 
     struct House* home; // Back pointer to the house
 
-    struct Ghost* ghostRoom;// Ghost if present
-
-    struct Hunter* hunters[MAX_ROOM_OCCUPANCY]; // Hunters inside room
-    int numHunters; // Number of hunters inside
-
     bool exitRoom; // True if this room is the exit
 
-    EvidenceByte evidence; // Evidence placed here
+    // Mutable state from here on
+    CACHE_ALIGNED _Atomic(struct Ghost*) ghostRoom; // Ghost if present (atomic, no room lock)
 
-    sem_t mutex; // Controls access to room data
-};
+    struct Occupancy occupants; // Hunters inside room
+
+    _Atomic EvidenceByte evidence; // Evidence placed here (atomic, no room lock)
 
-// Linked-list node for stack of rooms
-struct RoomNode{
-    struct Room* room; // Room stored
-    struct RoomNode* next; // Next node
+    sem_t mutex; // Guards occupants
 };
 
-// Stack of previously visited rooms
-struct RoomStack{
-    struct RoomNode* top; // Head of stack
+// Shortest routes, rebuilt whenever a layout is built
+struct RouteTable {
+    int size; // Rooms covered by next_hop and distance; 0 above ROUTES_ALL_PAIRS_MAX rooms
+    short* next_hop; // [from * size + to]: neighbour of from on a shortest path, -1 if none
+    short* distance; // [from * size + to]: moves along that path, -1 if unreachable
+    int* home_hop; // [room]: neighbour on a shortest path to the starting room, -1 if none (any size)
+    int* home_distance; // [room]: moves along that path, -1 if unreachable
 };
 
 // Hunter state
@@ -109,15 +131,17 @@ struct Hunter{
 
     struct House* home; // Pointer to house
     
-    struct Room* current; // Current room
+    // Mutable state from here on
+    CACHE_ALIGNED struct Room* current; // Current room
+    int roomSlot; // Position in current->occupants
     
     struct CaseFile* file; // Shared case file
     enum EvidenceType currentDevice; // Device hunter holds
     
-    struct RoomStack path; // Breadcrumb stack
-    
     int fear; // Fear counter
     int boredom; // Boredom counter
+    int moves; // Rooms moved through this run
+    struct Rng rng; // Random stream derived from the house seed and ID
     enum LogReason whyExit; // Exit reason
     bool exitHouse; // True when leaving
 };
@@ -127,9 +151,13 @@ struct Ghost {
     int id; // Provided ghost ID
     enum GhostType ghostType; // Actual ghost type
 
+    struct House* home; // Back pointer to the house
+
     struct Room* hidden; // Current room
 
     int boredom; // Boredom counter
+    int moves; // Rooms moved through this run
+    struct Rng rng; // Random stream derived from the house seed and ID
     bool exitSim; // True when ghost is done
 };
 
@@ -137,8 +165,11 @@ struct Ghost {
 struct House {
     struct Room* starting_room; // First room (Van)
     
-    struct Room rooms[MAX_ROOMS]; // Room list
+    struct Room* rooms; // Room list
     int room_count; // Total count
+    int* adjacency; // Neighbour indices of every room, back to back (compressed sparse rows)
+    int* adjacency_offsets; // room_count + 1 entries: room i's row starts at adjacency_offsets[i]
+    struct RouteTable routes; // Next hop and distance between rooms
 
     struct Hunter* hunter; // Dynamic hunter array
     int hunterCount; // Number of hunters
@@ -146,18 +177,31 @@ struct House {
 
     struct CaseFile fileCase; // Shared case file
 
-    struct Ghost ghost; // The ghost
+    CACHE_ALIGNED struct Ghost ghost; // The ghost
+
+    unsigned long long seed; // Master seed every random stream of this run is derived from
+    enum SimEngine engine; // How house_simulate() runs the agents
+    int workers; // Worker threads of ENGINE_POOL (0 = one per core)
 };
 
 // Function prototypes
 void ghost_init(struct Ghost* ghost, struct House* house); // Initialize ghost state
 void hunter_add(struct House* house, const char* name, int id); // Add a hunter to house
-void roomstack_push(struct RoomStack* stack, struct Room* room); // Push a room onto hunter breadcrumb stack
-struct Room* roomstack_pop(struct RoomStack* stack); // Pop a room from breadcrumb stack
-void roomstack_clear(struct RoomStack* stack); // Clear entire breadcrumb stack
+void house_reserve_hunters(struct House* house, int count); // Size the hunter array for count hunters in one allocation
+void house_reset(struct House* house); // Reset rooms, case file, ghost and hunters for another run
+void house_simulate(struct House* house); // Run all agents to completion with the house's engine
+void house_cleanup(struct House* house); // Free rooms, semaphores and hunters
+void casefile_init(struct CaseFile* file); // Empty the case file
+EvidenceByte casefile_add(struct CaseFile* file, EvidenceByte mask); // Add evidence bits, return the new mask
+EvidenceByte casefile_collected(const struct CaseFile* file); // Evidence bits collected so far
+bool casefile_solved(const struct CaseFile* file); // True once >=3 unique bits are collected or one ghost type fits
+void room_add_hunter(struct Room* room, struct Hunter* hunt); // Add a hunter to a room's occupants (room locked)
+void room_remove_hunter(struct Room* room, struct Hunter* hunt); // Remove a hunter from a room's occupants (room locked)
+void house_build_routes(struct House* house); // Fill house->routes from the room adjacency
+bool hunter_step(struct Hunter* hunt); // One hunter turn; false once the hunter has left
+bool ghost_step(struct Ghost* ghost); // One ghost turn; false once the ghost has left
 void *hunter_thread(void *arg); // Hunter thread logic
 void *ghost_thread(void *arg); // Ghost thread logic
-void room_init(struct Room* room, const char* name, bool is_exit); // Initialize a room
-void room_connect(struct Room* a, struct Room* b); // Bidirectional connection
+void room_init(struct Room* room, const char* name, bool is_exit); // Initialize a room without connections
 
 #endif // DEFS_H
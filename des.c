@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include "des.h"
+#include "rng.h"
+#include "logsink.h"
+#include "console.h"
+
+#define DES_GHOST -1 // Agent index of the ghost; hunters use their array index
+
+// A pending agent turn
+struct DesWakeup {
+    unsigned long long tick; // When the agent acts next
+    unsigned long long order; // Insertion order, breaks ties deterministically
+    int agent; // Hunter index or DES_GHOST
+};
+
+// Binary min-heap of wakeups
+struct DesQueue {
+    struct DesWakeup* items;
+    int count;
+    unsigned long long next_order;
+};
+
+static bool wakeup_before(const struct DesWakeup* a, const struct DesWakeup* b) {
+    return a->tick < b->tick || (a->tick == b->tick && a->order < b->order);
+}
+
+static void queue_push(struct DesQueue* queue, unsigned long long tick, int agent) {
+    int i = queue->count++;
+    struct DesWakeup item = { tick, queue->next_order++, agent };
+
+    // Sift up
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!wakeup_before(&item, &queue->items[parent])) break;
+        queue->items[i] = queue->items[parent];
+        i = parent;
+    }
+    queue->items[i] = item;
+}
+
+static struct DesWakeup queue_pop(struct DesQueue* queue) {
+    struct DesWakeup top = queue->items[0];
+    struct DesWakeup last = queue->items[--queue->count];
+
+    // Sift the last item down from the root
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= queue->count) break;
+        if (child + 1 < queue->count && wakeup_before(&queue->items[child + 1], &queue->items[child])) child++;
+        if (!wakeup_before(&queue->items[child], &last)) break;
+        queue->items[i] = queue->items[child];
+        i = child;
+    }
+    if (queue->count > 0) queue->items[i] = last;
+
+    return top;
+}
+
+void des_simulate(struct House* house) {
+    struct Rng delays;
+    rng_seed(&delays, house->seed, RNG_STREAM_SCHEDULER, 0);
+
+    // Every agent holds at most one wakeup at a time
+    struct DesQueue queue = {
+        .items = malloc(sizeof(struct DesWakeup) * (house->hunterCount + 1)),
+        .count = 0,
+        .next_order = 0
+    };
+
+    // Same start order as the threaded engine: ghost first, then hunters
+    queue_push(&queue, 0, DES_GHOST);
+    for (int i = 0; i < house->hunterCount; i++) {
+        queue_push(&queue, 0, i);
+    }
+
+    while (queue.count > 0) {
+        struct DesWakeup wakeup = queue_pop(&queue);
+
+        bool active = (wakeup.agent == DES_GHOST)
+                    ? ghost_step(&house->ghost)
+                    : hunter_step(&house->hunter[wakeup.agent]);
+
+        if (active) {
+            queue_push(&queue, wakeup.tick + (unsigned long long)rng_range(&delays, 1, DES_MAX_TURN_DELAY + 1), wakeup.agent);
+        }
+    }
+    free(queue.items);
+
+    logsink_flush_thread(); // Every agent logged from this thread
+    console_flush_thread();
+}
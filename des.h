@@ -0,0 +1,21 @@
+#ifndef DES_H
+#define DES_H
+
+#include "defs.h"
+
+// Longest delay, in ticks, between two turns of the same agent
+#define DES_MAX_TURN_DELAY 3
+
+/**
+ * @brief Run every agent of a house on the calling thread until all have left.
+ * @param[in,out] house Populated house with its ghost and hunters in place.
+ *
+ * Agent wakeups sit in a priority queue ordered by (tick, insertion order).
+ * After each turn the agent sleeps for 1..DES_MAX_TURN_DELAY ticks drawn
+ * from a scheduler stream seeded from house->seed, so the interleaving varies
+ * between seeds but a seed always replays the same run. No room or case
+ * file locks are taken.
+ */
+void des_simulate(struct House* house);
+
+#endif // DES_H
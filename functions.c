@@ -1,5 +1,11 @@
 #include "defs.h"
 #include "helpers.h"
+#include "logsink.h"
+#include "console.h"
+#include "des.h"
+#include "pool.h"
+#include "soa.h"
+#include "layout.h"
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
@@ -7,57 +13,46 @@
 // Initialize ghost fields and place ghost in a random room
 void ghost_init(struct Ghost* ghost, struct House* house) {
     ghost->id = DEFAULT_GHOST_ID;
+    ghost->home = house;
+    rng_seed(&ghost->rng, house->seed, RNG_STREAM_GHOST, ghost->id);
 
     // Pick a random ghost type
     const enum GhostType* types;
     int count = get_all_ghost_types(&types);
-    int index = rand_int_threadsafe(0, count);
+    int index = rng_range(&ghost->rng, 0, count);
     ghost->ghostType = types[index];
 
     // Pick a random starting room
-    int index2 = rand_int_threadsafe(0, house->room_count);
+    int index2 = rng_range(&ghost->rng, 0, house->room_count);
     ghost->hidden = &house->rooms[index2];
 
     ghost->boredom = 0;
+    ghost->moves = 0;
     ghost->exitSim = false;
 
     // Mark ghost as present in room
-    ghost->hidden->ghostRoom = ghost;
+    atomic_store_explicit(&ghost->hidden->ghostRoom, ghost, memory_order_relaxed);
 
-    log_ghost_init(ghost->id, ghost->hidden->name, ghost->ghostType);
+    log_ghost_init(ghost->id, ghost->hidden->index, ghost->ghostType);
 }
 
-// Add a new hunter to the house and assign a random device
-void hunter_add(struct House* house, const char* name, int id) {
-    // Expand hunter array if necessary
-    if (house->hunterCount == house->hunterCapacity){
-        house->hunterCapacity = (house->hunterCapacity == 0 ? 1 : house->hunterCapacity * 2);
-        house->hunter = realloc(house->hunter, house->hunterCapacity * sizeof(struct Hunter));
-    }
-
-    struct Hunter* hunt = &house->hunter[house->hunterCount];
-    
-    // Basic hunter info
-    strncpy(hunt->name, name, MAX_HUNTER_NAME - 1);
-    hunt->name[MAX_HUNTER_NAME - 1] = '\0';
+// Put a hunter in the van with a random device and fresh counters
+static void hunter_place(struct House* house, struct Hunter* hunt) {
     hunt->current = house->starting_room;
-    hunt->id = id;
-    hunt->home = house;
+    rng_seed(&hunt->rng, house->seed, RNG_STREAM_HUNTER, hunt->id);
 
     // Assign random investigation device
     const enum EvidenceType* devices;
     int devCount = get_all_evidence_types(&devices);
-    int index = rand_int_threadsafe(0, devCount);
+    int index = rng_range(&hunt->rng, 0, devCount);
     hunt->currentDevice = devices[index];
 
     // Share global case file
     hunt->file = &house->fileCase;
     
-    // Init breadcrumb stack
-    hunt->path.top = NULL;
-
     hunt->fear = 0;
     hunt->boredom = 0;
+    hunt->moves = 0;
 
     hunt->exitHouse = false;
     hunt->whyExit = LR_EVIDENCE;
@@ -65,269 +60,449 @@ void hunter_add(struct House* house, const char* name, int id) {
     // Add hunter to starting room
     struct Room* room = hunt->current;
     sem_wait(&room->mutex);
-    if (room->numHunters < MAX_ROOM_OCCUPANCY) {
-        room->hunters[room->numHunters++] = hunt;
-    }
+    room_add_hunter(room, hunt);
     sem_post(&room->mutex);
 
+    log_hunter_init(hunt->id, room->index, hunt->name, hunt->currentDevice);
+}
+
+// Move the hunters into an array of the given capacity (aligned, since hunters may start on a cache line)
+static void hunters_resize(struct House* house, int capacity) {
+    struct Hunter* grown = aligned_alloc(_Alignof(struct Hunter), capacity * sizeof(struct Hunter));
+    if (house->hunterCount > 0) {
+        memcpy(grown, house->hunter, house->hunterCount * sizeof(struct Hunter));
+    }
+    free(house->hunter);
+    house->hunter = grown;
+    house->hunterCapacity = capacity;
+}
+
+void house_reserve_hunters(struct House* house, int count) {
+    if (count > house->hunterCapacity) {
+        hunters_resize(house, count);
+    }
+}
+
+// Add a new hunter to the house and assign a random device
+void hunter_add(struct House* house, const char* name, int id) {
+    // Expand hunter array if necessary; house_reserve_hunters() up front avoids this
+    if (house->hunterCount == house->hunterCapacity){
+        hunters_resize(house, house->hunterCapacity == 0 ? 1 : house->hunterCapacity * 2);
+    }
+
+    struct Hunter* hunt = &house->hunter[house->hunterCount];
+    
+    // Basic hunter info
+    strncpy(hunt->name, name, MAX_HUNTER_NAME - 1);
+    hunt->name[MAX_HUNTER_NAME - 1] = '\0';
+    hunt->id = id;
+    hunt->home = house;
+
+    hunter_place(house, hunt);
+
     house->hunterCount++;
+}
+
+// Return the house to its starting state, keeping rooms, hunters and semaphores
+void house_reset(struct House* house) {
+    // Empty every room
+    for (int i = 0; i < house->room_count; i++) {
+        struct Room* room = &house->rooms[i];
+        atomic_store_explicit(&room->ghostRoom, NULL, memory_order_relaxed);
+        atomic_store_explicit(&room->evidence, 0, memory_order_relaxed);
+        room->occupants.count = 0; // Keep the slots for the next run
+    }
+
+    // Nothing collected yet
+    casefile_init(&house->fileCase);
+
+    ghost_init(&house->ghost, house);
+
+    // Same hunters, back in the van with new devices
+    for (int i = 0; i < house->hunterCount; i++) {
+        hunter_place(house, &house->hunter[i]);
+    }
+}
+
+// Run the ghost and every hunter until all of them leave
+void house_simulate(struct House* house) {
+    if (house->engine == ENGINE_EVENTS) {
+        des_simulate(house); // Single thread, no room locks
+        return;
+    }
+    if (house->engine == ENGINE_POOL) {
+        pool_simulate(house); // One worker per core instead of one thread per agent
+        return;
+    }
+    if (house->engine == ENGINE_SOA) {
+        soa_simulate(house); // Single thread, hunters as parallel arrays
+        return;
+    }
+
+    pthread_t ghostThread;
+    pthread_create(&ghostThread, NULL, ghost_thread, &house->ghost);
+
+    // Create one thread per hunter
+    pthread_t* hunterThreads = malloc(sizeof(pthread_t) * house->hunterCount);
+
+    for (int i = 0; i < house->hunterCount; i++) {
+        pthread_create(&hunterThreads[i], NULL, hunter_thread, &house->hunter[i]);
+    }
 
-    log_hunter_init(hunt->id, room->name, hunt->name, hunt->currentDevice);
+    // Thread join
+    for (int i = 0; i < house->hunterCount; i++) {
+        pthread_join(hunterThreads[i], NULL); // Wait for hunter to finish
+    }
+
+    // Wait for ghost thread
+    pthread_join(ghostThread, NULL);
 
+    free(hunterThreads);
 }
 
-// Add hunter to starting room
-void roomstack_push(struct RoomStack* stack, struct Room* room) {
-    struct RoomNode* newNode = malloc(sizeof(struct RoomNode)); // // allocate new node
-    newNode->room = room; // store room
-    newNode->next = stack->top; // insert at top
-    stack->top = newNode; // update head
+// Free the rooms, semaphores and hunters of a house
+void house_cleanup(struct House* house) {
+    house_free_layout(house);
+
+    free(house->hunter);
+    house->hunter = NULL;
+    house->hunterCount = 0;
+    house->hunterCapacity = 0;
 }
 
-// Pop room from breadcrumb stack
-struct Room* roomstack_pop(struct RoomStack* stack) {
-    if (stack->top == NULL) return NULL;
-    struct RoomNode* handleNode = stack->top; // get top node
-    struct Room* room = handleNode->room; // extract room
-    stack->top = handleNode->next; // move head
-    free(handleNode); // free node
-    return room; // return popped room
+void casefile_init(struct CaseFile* file) {
+    atomic_init(&file->collected, 0);
 }
 
-// Remove all rooms from breadcrumb stack
-void roomstack_clear(struct RoomStack* stack) {
-    while (stack->top != NULL) roomstack_pop(stack);  // pop until empty
+// One fetch-or per collection; solved is looked up from the mask, so there is nothing else to keep in step
+EvidenceByte casefile_add(struct CaseFile* file, EvidenceByte mask) {
+    return atomic_fetch_or_explicit(&file->collected, mask, memory_order_acq_rel) | mask;
 }
 
-// Main hunter behavior loop (movement, fear, boredom, evidence collection)
-void *hunter_thread(void* arg) {
-    struct Hunter* hunt = (struct Hunter*)arg;
-    struct House* house  = hunt->home;
-    struct Ghost* ghost  = &house->ghost;
-    struct CaseFile* file = &house->fileCase;
+EvidenceByte casefile_collected(const struct CaseFile* file) {
+    return atomic_load_explicit((_Atomic EvidenceByte*)&file->collected, memory_order_acquire);
+}
 
-    while (!hunt->exitHouse) {
+bool casefile_solved(const struct CaseFile* file) {
+    return ghost_deduce(casefile_collected(file))->solved;
+}
 
-        // Evidence Collection
-        if (hunt->current->evidence != 0) {
-            sem_wait(&hunt->current->mutex);
-            EvidenceByte mask = hunt->current->evidence;
-            hunt->current->evidence = 0;
-            sem_post(&hunt->current->mutex);
+// Append a hunter to the occupants, doubling the slots when the room is crowded
+void room_add_hunter(struct Room* room, struct Hunter* hunt) {
+    struct Occupancy* occ = &room->occupants;
+    if (occ->count == occ->capacity) {
+        occ->capacity = (occ->capacity == 0 ? ROOM_OCCUPANCY_INITIAL : occ->capacity * 2);
+        occ->hunters = realloc(occ->hunters, occ->capacity * sizeof(int));
+    }
 
-            enum EvidenceType ev = (enum EvidenceType)mask;
+    hunt->roomSlot = occ->count;
+    occ->hunters[occ->count++] = (int)(hunt - hunt->home->hunter);
+}
 
-            log_evidence(hunt->id, hunt->boredom, hunt->fear,
-                         hunt->current->name, ev);
+// Move the last occupant into the hunter's slot
+void room_remove_hunter(struct Room* room, struct Hunter* hunt) {
+    struct Occupancy* occ = &room->occupants;
+    int slot = hunt->roomSlot;
+    if (slot < 0 || slot >= occ->count || occ->hunters[slot] != (int)(hunt - hunt->home->hunter)) return; // Not listed here
 
-            // Update shared case file
-            sem_wait(&file->mutex);
-            file->collected |= mask;
-            file->solved = evidence_has_three_unique(file->collected);
-            sem_post(&file->mutex);
-        }
+    int last = occ->hunters[--occ->count];
+    occ->hunters[slot] = last;
+    hunt->home->hunter[last].roomSlot = slot;
+    hunt->roomSlot = -1;
+}
 
-        // Exit due to fear
-        if (hunt->fear >= HUNTER_FEAR_MAX) {
-            hunt->exitHouse = true;
-            hunt->whyExit = LR_AFRAID;
-            log_exit(hunt->id, hunt->boredom, hunt->fear,
-                     hunt->current->name, hunt->currentDevice, LR_AFRAID);
-            break;
+// Breadth-first search from every room; the first hop toward each room is inherited along the search tree
+static void routes_all_pairs(struct House* house, int* queue) {
+    struct RouteTable* routes = &house->routes;
+    int n = house->room_count;
+    routes->size = n;
+    routes->next_hop = malloc((size_t)n * n * sizeof(short));
+    routes->distance = malloc((size_t)n * n * sizeof(short));
+
+    for (int from = 0; from < n; from++) {
+        short* next_hop = routes->next_hop + (size_t)from * n;
+        short* distance = routes->distance + (size_t)from * n;
+        for (int to = 0; to < n; to++) {
+            next_hop[to] = -1;
+            distance[to] = -1;
         }
+        distance[from] = 0;
+
+        int head = 0, tail = 0;
+        queue[tail++] = from;
+        while (head < tail) {
+            const struct Room* room = &house->rooms[queue[head++]];
+            for (int c = 0; c < room->connectionCount; c++) {
+                int next = room->connected[c];
+                if (distance[next] >= 0) continue;
+
+                distance[next] = distance[room->index] + 1;
+                next_hop[next] = (room->index == from) ? next : next_hop[room->index];
+                queue[tail++] = next;
+            }
+        }
+    }
+}
 
-        // Exit due to boredom
-        if (hunt->boredom >= ENTITY_BOREDOM_MAX) {
-            hunt->exitHouse = true;
-            hunt->whyExit = LR_BORED;
-            log_exit(hunt->id, hunt->boredom, hunt->fear,
-                     hunt->current->name, hunt->currentDevice, LR_BORED);
-            break;
+void house_build_routes(struct House* house) {
+    struct RouteTable* routes = &house->routes;
+    int n = house->room_count;
+    int* queue = malloc(n * sizeof(int));
+
+    // Connections go both ways, so one search from the starting room gives
+    // every room its parent on a shortest path back: O(rooms + connections)
+    routes->home_hop = malloc(n * sizeof(int));
+    routes->home_distance = malloc(n * sizeof(int));
+    for (int r = 0; r < n; r++) {
+        routes->home_hop[r] = -1;
+        routes->home_distance[r] = -1;
+    }
+
+    int start = house->starting_room->index;
+    routes->home_distance[start] = 0;
+    int head = 0, tail = 0;
+    queue[tail++] = start;
+    while (head < tail) {
+        const struct Room* room = &house->rooms[queue[head++]];
+        for (int c = 0; c < room->connectionCount; c++) {
+            int next = room->connected[c];
+            if (routes->home_distance[next] >= 0) continue;
+
+            routes->home_distance[next] = routes->home_distance[room->index] + 1;
+            routes->home_hop[next] = room->index;
+            queue[tail++] = next;
         }
+    }
+
+    // Every pair only while the tables stay small (quadratic in the rooms)
+    routes->size = 0;
+    if (n <= ROUTES_ALL_PAIRS_MAX) {
+        routes_all_pairs(house, queue);
+    }
+
+    free(queue);
+}
+
+// Room semaphores are only needed when agents run on several threads
+static bool agent_concurrent(const struct House* house) {
+    return house->engine == ENGINE_THREADS || house->engine == ENGINE_POOL;
+}
+
+static void agent_lock(const struct House* house, sem_t* mutex) {
+    if (agent_concurrent(house)) sem_wait(mutex);
+}
+
+static void agent_unlock(const struct House* house, sem_t* mutex) {
+    if (agent_concurrent(house)) sem_post(mutex);
+}
 
-        // Check if case is solved
-        sem_wait(&file->mutex);
-        bool solved = file->solved;
-        sem_post(&file->mutex);
+// One hunter turn (evidence, fear, boredom, movement); false once the hunter has left
+bool hunter_step(struct Hunter* hunt) {
+    struct House* house  = hunt->home;
+    struct Ghost* ghost  = &house->ghost;
+    struct CaseFile* file = &house->fileCase;
 
-        if (solved) {
-            // Return to Van if case is solved
+    // Evidence Collection: the cheap load skips the exchange in empty rooms,
+    // and only the hunter whose exchange sees the bits collects them
+    EvidenceByte mask = 0;
+    if (atomic_load_explicit(&hunt->current->evidence, memory_order_relaxed) != 0) {
+        mask = atomic_exchange_explicit(&hunt->current->evidence, 0, memory_order_relaxed);
+    }
+    if (mask != 0) {
+        enum EvidenceType ev = (enum EvidenceType)mask;
 
-            log_return_to_van(hunt->id, hunt->boredom, hunt->fear,
-                              hunt->current->name, hunt->currentDevice, true);
+        log_evidence(hunt->id, hunt->boredom, hunt->fear,
+                     hunt->current->index, ev);
 
-            // Follow breadcrumb trail back to Van
-            while (hunt->current && strcmp(hunt->current->name, "Van") != 0) {
+        // Update shared case file
+        casefile_add(file, mask);
+    }
 
-                struct Room* from = hunt->current;
-                struct Room* to   = roomstack_pop(&hunt->path);
+    // Exit due to fear
+    if (hunt->fear >= HUNTER_FEAR_MAX) {
+        hunt->exitHouse = true;
+        hunt->whyExit = LR_AFRAID;
+        log_exit(hunt->id, hunt->boredom, hunt->fear,
+                 hunt->current->index, hunt->currentDevice, LR_AFRAID);
+        return false;
+    }
 
-                if (!to) break; 
+    // Exit due to boredom
+    if (hunt->boredom >= ENTITY_BOREDOM_MAX) {
+        hunt->exitHouse = true;
+        hunt->whyExit = LR_BORED;
+        log_exit(hunt->id, hunt->boredom, hunt->fear,
+                 hunt->current->index, hunt->currentDevice, LR_BORED);
+        return false;
+    }
 
-                log_move(hunt->id, hunt->boredom, hunt->fear,
-                         from->name, to->name, hunt->currentDevice);
+    // Check if case is solved
+    if (casefile_solved(file)) {
+        // Return to Van if case is solved
 
-                hunt->current = to;
-            }
+        log_return_to_van(hunt->id, hunt->boredom, hunt->fear,
+                          hunt->current->index, hunt->currentDevice, true);
 
-            // Arrived at van
-            log_return_to_van(hunt->id, hunt->boredom, hunt->fear,
-                              "Van", hunt->currentDevice, false);
+        // Follow the shortest route back to Van
+        int van = house->starting_room->index;
+        while (hunt->current->index != van) {
 
-            hunt->exitHouse = true;
-            hunt->whyExit = LR_EVIDENCE;
-            break;
-        }
+            struct Room* from = hunt->current;
+            int hop = house->routes.home_hop[from->index];
+
+            if (hop < 0) break; // Van unreachable from here
+            struct Room* to = &house->rooms[hop];
+
+            log_move(hunt->id, hunt->boredom, hunt->fear,
+                     from->index, to->index, hunt->currentDevice);
 
-        // Check if ghost is in the room 
-        sem_wait(&hunt->current->mutex);
-        bool ghost_here = (hunt->current->ghostRoom != NULL);
-        sem_post(&hunt->current->mutex);
-
-        // Fear rises if ghost present, boredom rises otherwise
-        if (ghost_here) {
-            hunt->boredom = 0;
-            hunt->fear++;
-        } else {
-            hunt->boredom++;
+            hunt->current = to;
+            hunt->moves++;
         }
 
-        // Exit room with corrent ghost match
-        if (hunt->current->exitRoom) {
+        // Arrived at van
+        log_return_to_van(hunt->id, hunt->boredom, hunt->fear,
+                          house->starting_room->index, hunt->currentDevice, false);
 
-            roomstack_clear(&hunt->path); // Clear breadcrumb path
+        hunt->exitHouse = true;
+        hunt->whyExit = LR_EVIDENCE;
+        return false;
+    }
 
-            // Check if collected evidence matches ghost type
-            sem_wait(&file->mutex);
-            bool full_match = ((file->collected & ghost->ghostType) == ghost->ghostType);
-            sem_post(&file->mutex);
+    // Check if ghost is in the room 
+    bool ghost_here = (atomic_load_explicit(&hunt->current->ghostRoom, memory_order_relaxed) != NULL);
 
-            if (full_match) {
-                // Remove hunter from room list
-                struct Room* r = hunt->current;
+    // Fear rises if ghost present, boredom rises otherwise
+    if (ghost_here) {
+        hunt->boredom = 0;
+        hunt->fear++;
+    } else {
+        hunt->boredom++;
+    }
 
-                sem_wait(&r->mutex);
-                for (int i = 0; i < r->numHunters; i++) {
-                    if (r->hunters[i] == hunt) {
-                        for (int j = i; j < r->numHunters - 1; j++)
-                            r->hunters[j] = r->hunters[j + 1];
+    // Exit room with corrent ghost match
+    if (hunt->current->exitRoom) {
 
-                        r->hunters[r->numHunters - 1] = NULL;
-                        r->numHunters--;
-                        break;
-                    }
-                }
-                sem_post(&r->mutex);
+        // Check if collected evidence matches ghost type
+        bool full_match = ((casefile_collected(file) & ghost->ghostType) == ghost->ghostType);
 
-                log_exit(hunt->id, hunt->boredom, hunt->fear,
-                         r->name, hunt->currentDevice, LR_EVIDENCE);
+        if (full_match) {
+            // Remove hunter from room list
+            struct Room* r = hunt->current;
 
-                hunt->current = NULL;
-                hunt->exitHouse = true;
-                break;
-            }
+            agent_lock(house, &r->mutex);
+            room_remove_hunter(r, hunt);
+            agent_unlock(house, &r->mutex);
+
+            log_exit(hunt->id, hunt->boredom, hunt->fear,
+                     r->index, hunt->currentDevice, LR_EVIDENCE);
+
+            hunt->current = NULL;
+            hunt->exitHouse = true;
+            return false;
         }
+    }
 
-        //Random movement to connected room
-        struct Room* cur = hunt->current;
-        int count = cur->connectionCount;
+    //Random movement to connected room
+    struct Room* cur = hunt->current;
+    int count = cur->connectionCount;
 
-        if (count > 0) {
+    if (count > 0) {
 
-            // Pick connected room
-            int index = rand_int_threadsafe(0, count);
-            struct Room* nextRoom = cur->connected[index];
+        // Pick connected room
+        int index = rng_range(&hunt->rng, 0, count);
+        struct Room* nextRoom = &house->rooms[cur->connected[index]];
 
-            // Remove hunter from current room
-            sem_wait(&cur->mutex);
-            for (int i = 0; i < cur->numHunters; i++) {
-                if (cur->hunters[i] == hunt) {
-                    for (int j = i; j < cur->numHunters - 1; j++)
-                        cur->hunters[j] = cur->hunters[j + 1];
+        // Remove hunter from current room
+        agent_lock(house, &cur->mutex);
+        room_remove_hunter(cur, hunt);
+        agent_unlock(house, &cur->mutex);
 
-                    cur->hunters[cur->numHunters - 1] = NULL;
-                    cur->numHunters--;
-                    break;
-                }
-            }
-            sem_post(&cur->mutex);
+        log_move(hunt->id, hunt->boredom, hunt->fear,
+                 cur->index, nextRoom->index, hunt->currentDevice);
 
-            roomstack_push(&hunt->path, cur); // Save breadcrumb
+        // Add hunter to next room
+        agent_lock(house, &nextRoom->mutex);
+        room_add_hunter(nextRoom, hunt);
+        agent_unlock(house, &nextRoom->mutex);
 
-            log_move(hunt->id, hunt->boredom, hunt->fear,
-                     cur->name, nextRoom->name, hunt->currentDevice);
+        hunt->current = nextRoom;
+        hunt->moves++;
+    }
 
-            // Add hunter to next room
-            sem_wait(&nextRoom->mutex);
-            if (nextRoom->numHunters < MAX_ROOM_OCCUPANCY) {
-                nextRoom->hunters[nextRoom->numHunters++] = hunt;
-            }
-            sem_post(&nextRoom->mutex);
+    return true;
+}
 
-            hunt->current = nextRoom;
-        }
+// Hunter thread: take turns until the hunter leaves
+void *hunter_thread(void* arg) {
+    struct Hunter* hunt = (struct Hunter*)arg;
+
+    while (hunter_step(hunt)) {
     }
 
+    logsink_flush_thread(); // Push this thread's buffered log lines to disk
+    console_flush_thread(); // And its pending console lines to stdout
+
     return NULL;
 }
 
-// Main ghost behavior loop (movement, evidence, exit)
-void *ghost_thread(void* arg) {
-    struct Ghost* ghost = (struct Ghost*)arg;
+// One ghost turn (evidence, movement, boredom); false once the ghost has left
+bool ghost_step(struct Ghost* ghost) {
     struct Room* current = ghost->hidden;
 
-    while (!ghost->exitSim) {
+    // Exit if too bored
+    if (ghost->boredom >= ENTITY_BOREDOM_MAX) {
+        ghost->exitSim = true;
+        log_ghost_exit(ghost->id, ghost->boredom, current->index);
+        return false;
+    }
 
-        // Exit if too bored
-        if (ghost->boredom >= ENTITY_BOREDOM_MAX) {
-            ghost->exitSim = true;
-            log_ghost_exit(ghost->id, ghost->boredom, current->name);
-            break;
-        }
+    // Randomly drop evidence
+    if (rng_range(&ghost->rng, 0, 6) == 0) {
+        const enum EvidenceType* devices;
+        int dcount = get_all_evidence_types(&devices);
+        int idx = rng_range(&ghost->rng, 0, dcount);
+        enum EvidenceType ev = devices[idx];
 
-        // Randomly drop evidence
-        if (rand_int_threadsafe(0, 6) == 0) {
-            const enum EvidenceType* devices;
-            int dcount = get_all_evidence_types(&devices);
-            int idx = rand_int_threadsafe(0, dcount);
-            enum EvidenceType ev = devices[idx];
+        atomic_fetch_or_explicit(&current->evidence, (EvidenceByte)ev, memory_order_relaxed);
 
-            sem_wait(&current->mutex);
-            current->evidence |= ev;
-            sem_post(&current->mutex);
+        log_ghost_evidence(ghost->id, ghost->boredom, current->index, ev);
+    }
 
-            log_ghost_evidence(ghost->id, ghost->boredom, current->name, ev);
-        }
+    // Move to a connected room
+    int count = current->connectionCount;
+    if (count > 0) {
+        int index = rng_range(&ghost->rng, 0, count);
+        struct Room* next = &ghost->home->rooms[current->connected[index]];
 
-        // Move to a connected room
-        int count = current->connectionCount;
-        if (count > 0) {
-            int index = rand_int_threadsafe(0, count);
-            struct Room* next = current->connected[index];
-
-            log_ghost_move(ghost->id, ghost->boredom,
-                           current->name, next->name);
-
-            // Leave current room
-            sem_wait(&current->mutex);
-            current->ghostRoom = NULL;
-            sem_post(&current->mutex);
-
-            // Enter next room
-            sem_wait(&next->mutex);
-            next->ghostRoom = ghost;
-            sem_post(&next->mutex);
-
-            ghost->hidden = next;
-            current = next;
-        } else {
-            // No movement possible
-            log_ghost_idle(ghost->id, ghost->boredom, current->name);
-        }
+        log_ghost_move(ghost->id, ghost->boredom,
+                       current->index, next->index);
 
-        ghost->boredom++;
+        // Leave current room and enter the next one
+        atomic_store_explicit(&current->ghostRoom, NULL, memory_order_relaxed);
+        atomic_store_explicit(&next->ghostRoom, ghost, memory_order_relaxed);
+
+        ghost->hidden = next;
+        ghost->moves++;
+    } else {
+        // No movement possible
+        log_ghost_idle(ghost->id, ghost->boredom, current->index);
     }
 
+    ghost->boredom++;
+    return true;
+}
+
+// Ghost thread: take turns until the ghost leaves
+void *ghost_thread(void* arg) {
+    struct Ghost* ghost = (struct Ghost*)arg;
+
+    while (ghost_step(ghost)) {
+    }
+
+    logsink_flush_thread(); // Push this thread's buffered log lines to disk
+    console_flush_thread(); // And its pending console lines to stdout
+
     return NULL;
 }
 
@@ -335,29 +510,18 @@ void *ghost_thread(void* arg) {
 void room_init(struct Room* room, const char* name, bool is_exit) {
     strcpy(room->name, name);
     
-    // Clear connections
+    // No connections until the layout fills the room's adjacency row
+    room->connected = NULL;
     room->connectionCount = 0;
-    for(int i = 0; i < MAX_CONNECTIONS; i++){
-        room->connected[i] = NULL;
-    }
 
-    room->ghostRoom = NULL;
+    atomic_init(&room->ghostRoom, NULL);
 
-    // Clear hunter occupancy
-    room->numHunters = 0;
-    for(int i = 0; i < MAX_ROOM_OCCUPANCY; i++){
-        room->hunters[i] = NULL;
-    }
+    // No hunters yet; slots are allocated on first entry
+    room->occupants = (struct Occupancy){0};
 
     room->exitRoom = is_exit;
-    room->evidence = 0;
+    atomic_init(&room->evidence, 0);
 
     // Mutex for room
     sem_init(&room->mutex, 0, 1);
 }
-
-// Create bidirectional connection between rooms
-void room_connect(struct Room* a, struct Room* b) {
-    a->connected[a->connectionCount++] = b;
-    b->connected[b->connectionCount++] = a;
-}
\ No newline at end of file
@@ -2,45 +2,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
-#include <time.h>
 #include <pthread.h>
-#include <stdint.h>
+#include <stdatomic.h>
 #include "helpers.h"
-
-// ---- House layout ----
-void house_populate_rooms(struct House* house) {
-    // Willow House layout from Phasmaphobia, DO NOT MODIFY HOUSE LAYOUT
-    house->room_count = 13;
-
-    room_init(house->rooms+0, "Van", true);
-    room_init(house->rooms+1, "Hallway", false);
-    room_init(house->rooms+2, "Master Bedroom", false);
-    room_init(house->rooms+3, "Boy's Bedroom", false);
-    room_init(house->rooms+4, "Bathroom", false);
-    room_init(house->rooms+5, "Basement", false);
-    room_init(house->rooms+6, "Basement Hallway", false);
-    room_init(house->rooms+7, "Right Storage Room", false);
-    room_init(house->rooms+8, "Left Storage Room", false);
-    room_init(house->rooms+9, "Kitchen", false);
-    room_init(house->rooms+10, "Living Room", false);
-    room_init(house->rooms+11, "Garage", false);
-    room_init(house->rooms+12, "Utility Room", false);
-
-    room_connect(house->rooms+0, house->rooms+1);    // Van - Hallway
-    room_connect(house->rooms+1, house->rooms+2);    // Hallway - Master Bedroom
-    room_connect(house->rooms+1, house->rooms+3);    // Hallway - Boy's Bedroom
-    room_connect(house->rooms+1, house->rooms+4);    // Hallway - Bathroom
-    room_connect(house->rooms+1, house->rooms+9);    // Hallway - Kitchen
-    room_connect(house->rooms+1, house->rooms+5);    // Hallway - Basement
-    room_connect(house->rooms+5, house->rooms+6);    // Basement - Basement Hallway
-    room_connect(house->rooms+6, house->rooms+7);    // Basement Hallway - Right Storage Room
-    room_connect(house->rooms+6, house->rooms+8);    // Basement Hallway - Left Storage Room
-    room_connect(house->rooms+9, house->rooms+10);   // Kitchen - Living Room
-    room_connect(house->rooms+9, house->rooms+11);   // Kitchen - Garage
-    room_connect(house->rooms+11, house->rooms+12);  // Garage - Utility Room
-
-    house->starting_room = house->rooms; // Van is at index 0
-}
+#include "logsink.h"
+#include "logqueue.h"
+#include "logformat.h"
+#include "console.h"
 
 // ---- to_string functions ----
 const char* evidence_to_string(enum EvidenceType evidence) {
@@ -186,381 +154,628 @@ int get_all_ghost_types(const enum GhostType** list) {
     return (int)(sizeof(ghost_types) / sizeof(ghost_types[0]));
 }
 
-// ---- Thread-safe random number generation ----
-int rand_int_threadsafe(int lower_inclusive, int upper_exclusive) {
-    static _Thread_local unsigned seed = 0;
+// ---- Evidence helpers ----
+static struct GhostDeduction deduction_table[EVIDENCE_MASKS];
+
+// Filled before main() runs, so lookups need neither a check nor a lock
+__attribute__((constructor))
+static void deduction_table_build(void) {
+    const enum GhostType* types;
+    int count = get_all_ghost_types(&types);
+
+    for (int mask = 0; mask < EVIDENCE_MASKS; mask++) {
+        struct GhostDeduction* entry = &deduction_table[mask];
+        int only = -1;
+        entry->exact = -1;
+        entry->evidence = (unsigned char)__builtin_popcount(mask);
+
+        for (int i = 0; i < count && i < 32; i++) {
+            if (((int)types[i] & mask) == mask) {
+                entry->candidates |= 1u << i;
+                entry->count++;
+                only = i;
+            }
+            if ((int)types[i] == mask) entry->exact = (signed char)i;
+        }
 
-    if (upper_exclusive <= lower_inclusive) {
-        return lower_inclusive;
+        entry->guess = entry->exact >= 0 ? entry->exact : (entry->count == 1 ? (signed char)only : -1);
+        entry->solved = entry->evidence >= 3 || entry->count == 1;
     }
+}
 
-    if (seed == 0) {
-        seed = (unsigned)time(NULL) ^ (unsigned)(uintptr_t)pthread_self();
-        if (seed == 0) {
-            seed = 0xA5A5A5A5u;
-        }
+const struct GhostDeduction* ghost_deduce(EvidenceByte mask) {
+    return &deduction_table[mask & (EVIDENCE_MASKS - 1)];
+}
+
+bool evidence_is_valid_ghost(EvidenceByte mask) {
+    return ghost_deduce(mask)->exact >= 0;
+}
+
+bool evidence_has_three_unique(EvidenceByte mask) {
+    return ghost_deduce(mask)->evidence >= 3;
+}
+
+// ---- Logging (Writes CSV logs, DO NOT MODIFY the file outputs: timestamp,type,id,room,device,boredom,fear,action,extra) ----
+
+// Global event order shared by every entity; timestamps are informational only
+static _Atomic unsigned long long log_sequence = 0;
+static bool log_sequence_column = false;
+static bool log_enabled = true;
+static enum LogFormat log_format = LOG_FORMAT_CSV;
+
+// House whose room names the records' indices refer to
+static const struct House* log_house = NULL;
+
+// Hunter names referenced by INIT records (records cannot carry strings), each stored once.
+// Chunk k holds LOG_NAME_FIRST << k names and never moves, so the writer thread reads
+// names without a lock: the queue hands it the record only after the name was stored.
+#define LOG_NAME_FIRST 64
+#define LOG_NAME_CHUNKS 26 // Room for more than INT_MAX names
+static char (*log_name_chunks[LOG_NAME_CHUNKS])[MAX_HUNTER_NAME];
+static int log_name_count = 0;
+
+// Open-addressing index of the names above (-1 marks a free slot); only interning uses it
+static int* log_name_index = NULL;
+static int log_name_index_size = 0;
+static pthread_mutex_t log_names_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void log_set_sequence_column(bool enabled) {
+    log_sequence_column = enabled;
+}
+
+void log_set_enabled(bool enabled) {
+    log_enabled = enabled;
+}
+
+void log_set_format(enum LogFormat format) {
+    log_format = format;
+}
+
+void log_attach_house(const struct House* house) {
+    log_house = house;
+}
+
+static const char* log_room_name(int room) {
+    if (!log_house || room < 0 || room >= log_house->room_count) {
+        return "";
     }
+    return log_house->rooms[room].name;
+}
 
-    unsigned span = (unsigned)(upper_exclusive - lower_inclusive);
-    unsigned value = (unsigned)rand_r(&seed) % span;
-    return lower_inclusive + (int)value;
+// Chunk k starts at name LOG_NAME_FIRST * (2^k - 1)
+static int log_name_chunk(int index) {
+    return 31 - __builtin_clz((unsigned)index / LOG_NAME_FIRST + 1);
 }
 
-// ---- Evidence helpers ----
-bool evidence_is_valid_ghost(EvidenceByte mask) {
-    const enum GhostType* ghost_types = NULL;
-    int ghost_count = get_all_ghost_types(&ghost_types);
+static char* log_name(int index) {
+    int chunk = log_name_chunk(index);
+    return log_name_chunks[chunk][index - LOG_NAME_FIRST * ((1 << chunk) - 1)];
+}
+
+// FNV-1a over the part of the name that is stored
+static unsigned log_name_hash(const char* name) {
+    unsigned hash = 2166136261u;
+    for (int i = 0; i < MAX_HUNTER_NAME - 1 && name[i]; i++) {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return hash;
+}
 
-    for (int index = 0; index < ghost_count; index++) {
-        if (mask == (EvidenceByte)ghost_types[index]) {
-            return true;
+// Rebuild the index at twice the size; called with log_names_lock held
+static void log_name_index_grow(void) {
+    free(log_name_index);
+    log_name_index_size = (log_name_index_size == 0 ? 2 * LOG_NAME_FIRST : log_name_index_size * 2);
+    log_name_index = malloc(log_name_index_size * sizeof(int));
+    memset(log_name_index, -1, log_name_index_size * sizeof(int));
+
+    for (int i = 0; i < log_name_count; i++) {
+        unsigned slot = log_name_hash(log_name(i)) & (log_name_index_size - 1);
+        while (log_name_index[slot] >= 0) slot = (slot + 1) & (log_name_index_size - 1);
+        log_name_index[slot] = i;
+    }
+}
+
+// Index of the name, storing it on first use; batch runs re-initialize the same hunters every run
+static int log_intern_name(const char* name) {
+    if (!name) name = "";
+
+    pthread_mutex_lock(&log_names_lock);
+    if (2 * (log_name_count + 1) > log_name_index_size) {
+        log_name_index_grow();
+    }
+
+    unsigned slot = log_name_hash(name) & (log_name_index_size - 1);
+    while (log_name_index[slot] >= 0) {
+        if (strncmp(log_name(log_name_index[slot]), name, MAX_HUNTER_NAME - 1) == 0) {
+            int index = log_name_index[slot];
+            pthread_mutex_unlock(&log_names_lock);
+            return index;
         }
+        slot = (slot + 1) & (log_name_index_size - 1);
     }
 
-    return false;
+    int index = log_name_count++;
+    int chunk = log_name_chunk(index);
+    if (!log_name_chunks[chunk]) {
+        log_name_chunks[chunk] = malloc(((size_t)LOG_NAME_FIRST << chunk) * MAX_HUNTER_NAME);
+    }
+    strncpy(log_name(index), name, MAX_HUNTER_NAME - 1);
+    log_name(index)[MAX_HUNTER_NAME - 1] = '\0';
+    log_name_index[slot] = index;
+    pthread_mutex_unlock(&log_names_lock);
+    return index;
 }
 
-bool evidence_has_three_unique(EvidenceByte mask) {
-    int count = 0;
-    while (mask) {
-        count += (mask & 1);
-        mask >>= 1;
+// Expand the action specific extra code back into the text of the last column
+static const char* log_extra_to_string(const struct LogRecord* record, char* scratch, size_t size) {
+    switch (record->action) {
+        case LOG_ACTION_INIT:
+            if (record->entity_type == LOG_ENTITY_GHOST) {
+                return ghost_to_string((enum GhostType)record->extra);
+            }
+            snprintf(scratch, size, "%s", log_name(record->extra));
+            return scratch;
+        case LOG_ACTION_MOVE:
+            return log_room_name(record->extra);
+        case LOG_ACTION_EVIDENCE:
+            return evidence_to_string((enum EvidenceType)record->extra);
+        case LOG_ACTION_SWAP:
+            snprintf(scratch, size, "%s->%s",
+                     evidence_to_string((enum EvidenceType)record->extra),
+                     evidence_to_string((enum EvidenceType)record->device));
+            return scratch;
+        case LOG_ACTION_EXIT:
+            return record->entity_type == LOG_ENTITY_HUNTER ? exit_reason_to_string((enum LogReason)record->extra) : "";
+        case LOG_ACTION_RETURN_START:
+            return "start";
+        case LOG_ACTION_RETURN_COMPLETE:
+            return "complete";
+        default:
+            return "";
     }
-    return count >= 3;
 }
 
-// ---- Logging (Writes CSV logs, DO NOT MODIFY the file outputs: timestamp,type,id,room,device,boredom,fear,action,extra) ----
+// Format one record as a CSV line and append it to the entity's log file
+static void emit_csv_record(const struct LogRecord* record) {
+    char scratch[MAX_HUNTER_NAME * 2];
+    char line[512];
 
-// These enums are just for logging purposes, not needed elsewhere
-enum LogEntityType {
-    LOG_ENTITY_HUNTER = 0,
-    LOG_ENTITY_GHOST = 1
-};
-
-struct LogRecord {
-    enum LogEntityType entity_type;
-    int                entity_id;
-    const char*        room;
-    const char*        device;
-    int                boredom;
-    int                fear;
-    const char*        action;
-    const char*        extra;
-};
-
-static const char* log_entity_type_to_string(enum LogEntityType type) {
-    switch (type) {
-        case LOG_ENTITY_HUNTER:
-            return "hunter";
-        case LOG_ENTITY_GHOST:
-            return "ghost";
-        default:
-            return "unknown";
+    const char* device = record->device ? evidence_to_string((enum EvidenceType)record->device) : "";
+    size_t length = log_format_csv(line, sizeof(line), record,
+                                   log_room_name(record->room),
+                                   device,
+                                   log_extra_to_string(record, scratch, sizeof(scratch)),
+                                   log_sequence_column);
+
+    if (length > 0) {
+        logsink_write(record->entity_id, line, length);
     }
 }
 
-static void write_log_record(const struct LogRecord* record) {
-    static _Thread_local unsigned line_count = 0;
+// Position of an evidence mask in the header's evidence table
+static unsigned char log_binary_evidence(int mask) {
+    if (mask == 0) {
+        return LOGBIN_DEVICE_NONE;
+    }
 
-    if (line_count >= 100000) {
-        fprintf(stderr, "Log capped for entity %d; stopping to prevent infinite growth.\n", record->entity_id);
-        exit(1);
+    const enum EvidenceType* types;
+    int count = get_all_evidence_types(&types);
+    for (int i = 0; i < count; i++) {
+        if ((int)types[i] == mask) return (unsigned char)i;
     }
+    return LOGBIN_DEVICE_UNKNOWN; // Several bits at once, printed as "unknown"
+}
+
+// Position of a ghost type in the header's ghost table
+static unsigned log_binary_ghost(int type) {
+    int index = ghost_deduce((EvidenceByte)type)->exact;
+    return index >= 0 ? (unsigned)index : LOGBIN_INDEX_NONE;
+}
+
+// Encode one record as a fixed-width binary entry and append it to the entity's log file
+static void emit_binary_record(const struct LogRecord* record) {
+    struct LogBinaryRecord entry = {
+        .sequence = record->sequence,
+        .timestamp = record->timestamp,
+        .entity_id = record->entity_id,
+        .room = record->room < 0 ? LOGBIN_INDEX_NONE : (unsigned)record->room,
+        .extra = LOGBIN_INDEX_NONE,
+        .boredom = record->boredom,
+        .fear = record->fear,
+        .entity_type = record->entity_type,
+        .action = record->action,
+        .device = log_binary_evidence(record->device)
+    };
+
+    bool with_name = false;
+    switch (record->action) {
+        case LOG_ACTION_INIT:
+            if (record->entity_type == LOG_ENTITY_GHOST) {
+                entry.extra = log_binary_ghost(record->extra);
+            } else {
+                with_name = true; // Name bytes follow the record
+            }
+            break;
+        case LOG_ACTION_MOVE:
+            entry.extra = (unsigned)record->extra;
+            break;
+        case LOG_ACTION_EVIDENCE:
+        case LOG_ACTION_SWAP:
+            entry.extra = log_binary_evidence(record->extra);
+            break;
+        case LOG_ACTION_EXIT:
+            if (record->entity_type == LOG_ENTITY_HUNTER) {
+                entry.extra = (unsigned)record->extra;
+            }
+            break;
+        default:
+            break;
+    }
+
+    unsigned char bytes[LOGBIN_RECORD_SIZE + LOGBIN_NAME_SIZE];
+    size_t length = LOGBIN_RECORD_SIZE;
+    logbin_encode_record(&entry, bytes);
+
+    if (with_name) {
+        memset(bytes + LOGBIN_RECORD_SIZE, 0, LOGBIN_NAME_SIZE);
+        strncpy((char*)bytes + LOGBIN_RECORD_SIZE, log_name(record->extra), LOGBIN_NAME_SIZE - 1);
+        length += LOGBIN_NAME_SIZE;
+    }
+
+    logsink_write(record->entity_id, (const char*)bytes, length);
+}
+
+static void emit_log_record(const struct LogRecord* record) {
+    if (log_format == LOG_FORMAT_BINARY) {
+        emit_binary_record(record);
+    } else {
+        emit_csv_record(record);
+    }
+}
 
-    char filename[64];
-    snprintf(filename, sizeof(filename), "log_%d.csv", record->entity_id);
+// Header of binary logs: the string tables every index in the records points into
+static void log_configure_binary_sink(void) {
+    static const enum LogReason reasons[] = { LR_EVIDENCE, LR_BORED, LR_AFRAID };
 
-    FILE* log_file = fopen(filename, "a");
+    const enum EvidenceType* evidence_types;
+    const enum GhostType* ghost_types;
+    int evidence_count = get_all_evidence_types(&evidence_types);
+    int ghost_count = get_all_ghost_types(&ghost_types);
+    int room_count = log_house ? log_house->room_count : 0;
+    int reason_count = (int)(sizeof(reasons) / sizeof(reasons[0]));
+
+    struct LogBinaryTables tables = {
+        .rooms = malloc(sizeof(char*) * (room_count + 1)),
+        .room_count = (unsigned)room_count,
+        .evidence = malloc(sizeof(char*) * evidence_count),
+        .evidence_count = (unsigned)evidence_count,
+        .ghosts = malloc(sizeof(char*) * ghost_count),
+        .ghost_count = (unsigned)ghost_count,
+        .reasons = malloc(sizeof(char*) * reason_count),
+        .reason_count = (unsigned)reason_count
+    };
+
+    // The tables only borrow the strings, so free the arrays but not their entries
+    for (int i = 0; i < room_count; i++) tables.rooms[i] = log_house->rooms[i].name;
+    for (int i = 0; i < evidence_count; i++) tables.evidence[i] = evidence_to_string(evidence_types[i]);
+    for (int i = 0; i < ghost_count; i++) tables.ghosts[i] = ghost_to_string(ghost_types[i]);
+    for (int i = 0; i < reason_count; i++) tables.reasons[i] = exit_reason_to_string(reasons[i]);
+
+    size_t header_len;
+    unsigned char* header = logbin_encode_header(&tables, &header_len);
+    logsink_configure("bin", header, header_len);
+
+    free(header);
+    free(tables.rooms);
+    free(tables.evidence);
+    free(tables.ghosts);
+    free(tables.reasons);
+}
 
-    if (!log_file) {
+// Stamp the record and hand it to the writer thread (or write it inline if none runs)
+static void write_log_record(struct LogRecord* record) {
+    if (!log_enabled) {
         return;
     }
 
     struct timeval tv;
     gettimeofday(&tv, NULL);
-    long long timestamp = (long long)tv.tv_sec * 1000LL + (long long)tv.tv_usec / 1000LL;
-
-    const char* entity = log_entity_type_to_string(record->entity_type);
-    const char* room = record->room ? record->room : "";
-    const char* device = record->device ? record->device : "";
-    const char* action = record->action ? record->action : "";
-    const char* extra = record->extra ? record->extra : "";
-
-    fprintf(log_file,
-            "%lld,%s,%d,%s,%s,%d,%d,%s,%s\n",
-            timestamp,
-            entity,
-            record->entity_id,
-            room,
-            device,
-            record->boredom,
-            record->fear,
-            action,
-            extra);
-
-    fclose(log_file);
-    line_count++;
-
-    // Short pause helps ensure successive logs receive distinct timestamps.
-    struct timespec pause = {0, 2 * 1000 * 1000}; // 2 ms
-    nanosleep(&pause, NULL);
-}
-
-void log_move(int hunter_id, int boredom, int fear, const char* from_room, const char* to_room, enum EvidenceType device) {
+    record->timestamp = (long long)tv.tv_sec * 1000LL + (long long)tv.tv_usec / 1000LL;
+    record->sequence = atomic_fetch_add_explicit(&log_sequence, 1, memory_order_relaxed);
+
+    if (!logqueue_push(record)) {
+        emit_log_record(record);
+    }
+}
+
+bool log_start(size_t capacity, enum LogBackpressure policy) {
+    if (log_format == LOG_FORMAT_BINARY) {
+        log_configure_binary_sink();
+    } else {
+        logsink_configure("csv", NULL, 0);
+    }
+    return logqueue_start(capacity, policy, emit_log_record);
+}
+
+bool log_shutdown(void) {
+    unsigned long long dropped = logqueue_stop();
+    if (dropped > 0) {
+        fprintf(stderr, "Log queue was full; %llu records were dropped.\n", dropped);
+    }
+
+    struct LogSinkLoss loss = logsink_close_all();
+    if (loss.over_budget > 0) {
+        fprintf(stderr, "Log disk budget reached; %llu bytes of log data were not written.\n", loss.over_budget);
+    }
+    if (loss.failed > 0) {
+        fprintf(stderr, "Log files could not be written; %llu bytes of log data were lost.\n", loss.failed);
+    }
+
+    pthread_mutex_lock(&log_names_lock);
+    for (int chunk = 0; chunk < LOG_NAME_CHUNKS; chunk++) {
+        free(log_name_chunks[chunk]);
+        log_name_chunks[chunk] = NULL;
+    }
+    log_name_count = 0;
+    free(log_name_index);
+    log_name_index = NULL;
+    log_name_index_size = 0;
+    pthread_mutex_unlock(&log_names_lock);
+
+    return loss.failed == 0;
+}
+
+void log_move(int hunter_id, int boredom, int fear, int from_room, int to_room, enum EvidenceType device) {
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_HUNTER,
         .entity_id = hunter_id,
         .room = from_room,
-        .device = evidence_to_string(device),
+        .device = (unsigned char)device,
         .boredom = boredom,
         .fear = fear,
-        .action = "MOVE",
+        .action = LOG_ACTION_MOVE,
         .extra = to_room
     };
 
     write_log_record(&record);
 
-    printf("Hunter %d using %s moved from %s to %s (bored=%d fear=%d)\n",
-           hunter_id,
-           evidence_to_string(device),
-           from_room ? from_room : "",
-           to_room ? to_room : "",
-           boredom,
-           fear);
+    console_event("Hunter %d using %s moved from %s to %s (bored=%d fear=%d)\n",
+                  hunter_id,
+                  evidence_to_string(device),
+                  log_room_name(from_room),
+                  log_room_name(to_room),
+                  boredom,
+                  fear);
 }
 
-void log_evidence(int hunter_id, int boredom, int fear, const char* room_name, enum EvidenceType device) {
+void log_evidence(int hunter_id, int boredom, int fear, int room, enum EvidenceType device) {
     const char* evidence = evidence_to_string(device);
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_HUNTER,
         .entity_id = hunter_id,
-        .room = room_name,
-        .device = evidence,
+        .room = room,
+        .device = (unsigned char)device,
         .boredom = boredom,
         .fear = fear,
-        .action = "EVIDENCE",
-        .extra = evidence
+        .action = LOG_ACTION_EVIDENCE,
+        .extra = (int)device
     };
 
     write_log_record(&record);
 
-    printf("Hunter %d using %s gathered evidence in %s (bored=%d fear=%d)\n",
-           hunter_id,
-           evidence,
-           room_name ? room_name : "",
-           boredom,
-           fear);
+    console_event("Hunter %d using %s gathered evidence in %s (bored=%d fear=%d)\n",
+                  hunter_id,
+                  evidence,
+                  log_room_name(room),
+                  boredom,
+                  fear);
 }
 
 void log_swap(int hunter_id, int boredom, int fear, enum EvidenceType from_device, enum EvidenceType to_device) {
-    char extra[64];
     const char* from_text = evidence_to_string(from_device);
     const char* to_text = evidence_to_string(to_device);
-    snprintf(extra, sizeof(extra), "%s->%s", from_text, to_text);
 
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_HUNTER,
         .entity_id = hunter_id,
-        .room = NULL,
-        .device = to_text,
+        .room = -1,
+        .device = (unsigned char)to_device,
         .boredom = boredom,
         .fear = fear,
-        .action = "SWAP",
-        .extra = extra
+        .action = LOG_ACTION_SWAP,
+        .extra = (int)from_device
     };
 
     write_log_record(&record);
 
-    printf("Hunter %d swapped devices: %s -> %s (bored=%d fear=%d)\n",
-           hunter_id,
-           from_text,
-           to_text,
-           boredom,
-           fear);
+    console_event("Hunter %d swapped devices: %s -> %s (bored=%d fear=%d)\n",
+                  hunter_id,
+                  from_text,
+                  to_text,
+                  boredom,
+                  fear);
 }
 
-void log_exit(int hunter_id, int boredom, int fear, const char* room_name, enum EvidenceType device, enum LogReason reason) {
+void log_exit(int hunter_id, int boredom, int fear, int room, enum EvidenceType device, enum LogReason reason) {
     const char* device_text = evidence_to_string(device);
     const char* reason_text = exit_reason_to_string(reason);
 
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_HUNTER,
         .entity_id = hunter_id,
-        .room = room_name,
-        .device = device_text,
+        .room = room,
+        .device = (unsigned char)device,
         .boredom = boredom,
         .fear = fear,
-        .action = "EXIT",
-        .extra = reason_text
+        .action = LOG_ACTION_EXIT,
+        .extra = (int)reason
     };
 
     write_log_record(&record);
 
-    printf("Hunter %d using %s exited at %s (reason=%s, bored=%d fear=%d)\n",
-           hunter_id,
-           device_text,
-           room_name ? room_name : "",
-           reason_text,
-           boredom,
-           fear);
+    console_event("Hunter %d using %s exited at %s (reason=%s, bored=%d fear=%d)\n",
+                  hunter_id,
+                  device_text,
+                  log_room_name(room),
+                  reason_text,
+                  boredom,
+                  fear);
 }
 
-void log_return_to_van(int hunter_id, int boredom, int fear, const char* room_name, enum EvidenceType device, bool heading_home) {
+void log_return_to_van(int hunter_id, int boredom, int fear, int room, enum EvidenceType device, bool heading_home) {
     const char* device_text = evidence_to_string(device);
-    const char* extra = heading_home ? "start" : "complete";
-    const char* action = heading_home ? "RETURN_START" : "RETURN_COMPLETE";
 
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_HUNTER,
         .entity_id = hunter_id,
-        .room = room_name,
-        .device = device_text,
+        .room = room,
+        .device = (unsigned char)device,
         .boredom = boredom,
         .fear = fear,
-        .action = action,
-        .extra = extra
+        .action = heading_home ? LOG_ACTION_RETURN_START : LOG_ACTION_RETURN_COMPLETE,
+        .extra = 0
     };
 
     write_log_record(&record);
 
     if (heading_home) {
-        printf("Hunter %d using %s heading to van from %s (bored=%d fear=%d)\n",
-               hunter_id,
-               device_text,
-               room_name ? room_name : "",
-               boredom,
-               fear);
+        console_event("Hunter %d using %s heading to van from %s (bored=%d fear=%d)\n",
+                      hunter_id,
+                      device_text,
+                      log_room_name(room),
+                      boredom,
+                      fear);
     } else {
-        printf("Hunter %d using %s finished return at %s (bored=%d fear=%d)\n",
-               hunter_id,
-               device_text,
-               room_name ? room_name : "",
-               boredom,
-               fear);
+        console_event("Hunter %d using %s finished return at %s (bored=%d fear=%d)\n",
+                      hunter_id,
+                      device_text,
+                      log_room_name(room),
+                      boredom,
+                      fear);
     }
 }
 
-void log_hunter_init(int hunter_id, const char* room_name, const char* hunter_name, enum EvidenceType device) {
+void log_hunter_init(int hunter_id, int room, const char* hunter_name, enum EvidenceType device) {
     const char* device_text = evidence_to_string(device);
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_HUNTER,
         .entity_id = hunter_id,
-        .room = room_name,
-        .device = device_text,
+        .room = room,
+        .device = (unsigned char)device,
         .boredom = 0,
         .fear = 0,
-        .action = "INIT",
-        .extra = hunter_name ? hunter_name : ""
+        .action = LOG_ACTION_INIT,
+        .extra = log_enabled ? log_intern_name(hunter_name) : 0
     };
 
     write_log_record(&record);
-    printf("Hunter %d (%s) initialized in %s with %s\n",
-           hunter_id,
-           hunter_name ? hunter_name : "unknown",
-           room_name ? room_name : "",
-           device_text);
+    console_event("Hunter %d (%s) initialized in %s with %s\n",
+                  hunter_id,
+                  hunter_name ? hunter_name : "unknown",
+                  log_room_name(room),
+                  device_text);
 }
 
-void log_ghost_init(int ghost_id, const char* room_name, enum GhostType type) {
+void log_ghost_init(int ghost_id, int room, enum GhostType type) {
     const char* type_text = ghost_to_string(type);
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_GHOST,
         .entity_id = ghost_id,
-        .room = room_name,
-        .device = NULL,
+        .room = room,
+        .device = 0,
         .boredom = 0,
         .fear = 0,
-        .action = "INIT",
-        .extra = type_text
+        .action = LOG_ACTION_INIT,
+        .extra = (int)type
     };
 
     write_log_record(&record);
-    printf("Ghost %d (%s) initialized in %s\n",
-           ghost_id,
-           type_text,
-           room_name ? room_name : "");
+    console_event("Ghost %d (%s) initialized in %s\n",
+                  ghost_id,
+                  type_text,
+                  log_room_name(room));
 }
 
-void log_ghost_move(int ghost_id, int boredom, const char* from_room, const char* to_room) {
+void log_ghost_move(int ghost_id, int boredom, int from_room, int to_room) {
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_GHOST,
         .entity_id = ghost_id,
         .room = from_room,
-        .device = NULL,
+        .device = 0,
         .boredom = boredom,
         .fear = 0,
-        .action = "MOVE",
+        .action = LOG_ACTION_MOVE,
         .extra = to_room
     };
 
     write_log_record(&record);
 
-    printf("Ghost %d [bored=%d] MOVE %s -> %s\n",
-           ghost_id,
-           boredom,
-           from_room ? from_room : "",
-           to_room ? to_room : "");
+    console_event("Ghost %d [bored=%d] MOVE %s -> %s\n",
+                  ghost_id,
+                  boredom,
+                  log_room_name(from_room),
+                  log_room_name(to_room));
 }
 
-void log_ghost_evidence(int ghost_id, int boredom, const char* room_name, enum EvidenceType evidence) {
+void log_ghost_evidence(int ghost_id, int boredom, int room, enum EvidenceType evidence) {
     const char* evidence_text = evidence_to_string(evidence);
 
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_GHOST,
         .entity_id = ghost_id,
-        .room = room_name,
-        .device = NULL,
+        .room = room,
+        .device = 0,
         .boredom = boredom,
         .fear = 0,
-        .action = "EVIDENCE",
-        .extra = evidence_text
+        .action = LOG_ACTION_EVIDENCE,
+        .extra = (int)evidence
     };
 
     write_log_record(&record);
 
-    printf("Ghost %d [bored=%d] EVIDENCE %s in %s\n",
-           ghost_id,
-           boredom,
-           evidence_text,
-           room_name ? room_name : "");
+    console_event("Ghost %d [bored=%d] EVIDENCE %s in %s\n",
+                  ghost_id,
+                  boredom,
+                  evidence_text,
+                  log_room_name(room));
 }
 
-void log_ghost_exit(int ghost_id, int boredom, const char* room_name) {
+void log_ghost_exit(int ghost_id, int boredom, int room) {
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_GHOST,
         .entity_id = ghost_id,
-        .room = room_name,
-        .device = NULL,
+        .room = room,
+        .device = 0,
         .boredom = boredom,
         .fear = 0,
-        .action = "EXIT",
-        .extra = ""
+        .action = LOG_ACTION_EXIT,
+        .extra = 0
     };
 
     write_log_record(&record);
 
-    printf("Ghost %d [bored=%d] EXIT %s\n",
-           ghost_id,
-           boredom,
-           room_name ? room_name : "");
+    console_event("Ghost %d [bored=%d] EXIT %s\n",
+                  ghost_id,
+                  boredom,
+                  log_room_name(room));
 }
 
-void log_ghost_idle(int ghost_id, int boredom, const char* room_name) {
+void log_ghost_idle(int ghost_id, int boredom, int room) {
     struct LogRecord record = {
         .entity_type = LOG_ENTITY_GHOST,
         .entity_id = ghost_id,
-        .room = room_name,
-        .device = NULL,
+        .room = room,
+        .device = 0,
         .boredom = boredom,
         .fear = 0,
-        .action = "IDLE",
-        .extra = ""
+        .action = LOG_ACTION_IDLE,
+        .extra = 0
     };
 
     write_log_record(&record);
 
-    printf("Ghost %d [bored=%d] IDLE in %s\n",
-           ghost_id,
-           boredom,
-           room_name ? room_name : "");
+    console_event("Ghost %d [bored=%d] IDLE in %s\n",
+                  ghost_id,
+                  boredom,
+                  log_room_name(room));
 }
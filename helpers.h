@@ -1,7 +1,11 @@
 #ifndef HELPERS_H
 #define HELPERS_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "defs.h"
+#include "logqueue.h"
+#include "logformat.h"
 
 /**
  * @brief Return the lowercase token for a device.
@@ -38,13 +42,24 @@ int get_all_evidence_types(const enum EvidenceType** list);
  */
 int get_all_ghost_types(const enum GhostType** list);
 
+#define EVIDENCE_MASKS 128 // Every combination of the seven evidence bits
+
+// What one evidence mask says about the ghost (get_all_ghost_types() order, at most 32 types)
+struct GhostDeduction {
+    uint32_t candidates; // Bit i set when ghost type i has every bit of the mask
+    unsigned char count; // Candidates left
+    unsigned char evidence; // Distinct evidence types in the mask
+    signed char exact; // Ghost type whose evidence is exactly the mask, -1 if none
+    signed char guess; // exact, or else the only candidate left, -1 if neither
+    bool solved; // Three or more evidence types, or a single candidate: hunters head back
+};
+
 /**
- * @brief Thread-safe random integer helper.
- * @param[in] lower_inclusive Minimum value (inclusive).
- * @param[in] upper_exclusive Maximum value (exclusive).
- * @return Random number in [lower_inclusive, upper_exclusive).
+ * @brief Look up everything an evidence mask says about the ghost.
+ * @param[in] mask Combined evidence mask.
+ * @return Entry of a 128-entry table filled at startup; one load per query.
  */
-int rand_int_threadsafe(int lower_inclusive, int upper_exclusive);
+const struct GhostDeduction* ghost_deduce(EvidenceByte mask);
 
 /**
  * @brief Verify whether an evidence mask matches a supported ghost type.
@@ -61,31 +76,74 @@ bool evidence_is_valid_ghost(EvidenceByte mask);
 bool evidence_has_three_unique(EvidenceByte mask);
 
 /**
- * @brief Populate the house structure with the Willow layout.
- * @param[in,out] house House to populate; starting_room is set to the van.
+ * @brief Enable the trailing sequence column in CSV logs.
+ * @param[in] enabled true to append ",<seq>" to every line.
+ *
+ * Every record gets a process-wide, strictly increasing sequence number that
+ * totally orders events across all entities. It is only written when enabled
+ * so the default nine-column format is unchanged.
+ */
+void log_set_sequence_column(bool enabled);
+
+/**
+ * @brief Turn log file output on or off.
+ * @param[in] enabled false to drop every record before it is stamped or queued.
+ *
+ * Console output is unaffected. Logging is on by default.
+ */
+void log_set_enabled(bool enabled);
+
+/**
+ * @brief Select CSV or binary log files.
+ * @param[in] format Output format; must be chosen before log_start().
+ */
+void log_set_format(enum LogFormat format);
+
+/**
+ * @brief Register the house whose room indices the log records refer to.
+ * @param[in] house House that stays alive until log_shutdown().
+ */
+void log_attach_house(const struct House* house);
+
+/**
+ * @brief Start the asynchronous log writer.
+ * @param[in] capacity Ring size in records.
+ * @param[in] policy What agent threads do when the ring is full.
+ * @return true when records are handed to the writer thread.
+ *
+ * Until this is called (or if it fails) records are formatted and written
+ * on the calling thread.
+ */
+bool log_start(size_t capacity, enum LogBackpressure policy);
+
+/**
+ * @brief Drain the log writer and close every log file.
+ * @return false when log data was lost because a file could not be opened or written.
+ *
+ * Call after all agent threads have been joined.
  */
-void house_populate_rooms(struct House* house);
+bool log_shutdown(void);
 
 /**
  * @brief Append a MOVE entry for a hunter.
  * @param[in] id Hunter identifier.
  * @param[in] boredom Current boredom level.
  * @param[in] fear Current fear level.
- * @param[in] from Source room name.
- * @param[in] to Destination room name.
+ * @param[in] from Source room index.
+ * @param[in] to Destination room index.
  * @param[in] device Device the hunter is holding.
  */
-void log_move(int id, int boredom, int fear, const char* from, const char* to, enum EvidenceType device);
+void log_move(int id, int boredom, int fear, int from, int to, enum EvidenceType device);
 
 /**
  * @brief Append an EVIDENCE entry for a hunter.
  * @param[in] id Hunter identifier.
  * @param[in] boredom Current boredom level.
  * @param[in] fear Current fear level.
- * @param[in] room Room where evidence was collected.
+ * @param[in] room Index of the room where evidence was collected.
  * @param[in] device Device used to collect evidence.
  */
-void log_evidence(int id, int boredom, int fear, const char* room, enum EvidenceType device);
+void log_evidence(int id, int boredom, int fear, int room, enum EvidenceType device);
 
 /**
  * @brief Append a SWAP entry for a hunter.
@@ -102,72 +160,72 @@ void log_swap(int id, int boredom, int fear, enum EvidenceType from, enum Eviden
  * @param[in] id Hunter identifier.
  * @param[in] boredom Current boredom level.
  * @param[in] fear Current fear level.
- * @param[in] room Exit room name.
+ * @param[in] room Exit room index.
  * @param[in] device Device carried.
  * @param[in] reason Exit reason.
  */
-void log_exit(int id, int boredom, int fear, const char* room, enum EvidenceType device, enum LogReason reason);
+void log_exit(int id, int boredom, int fear, int room, enum EvidenceType device, enum LogReason reason);
 
 /**
  * @brief Append a MOVE entry for the ghost.
  * @param[in] id Ghost identifier.
  * @param[in] boredom Current boredom level.
- * @param[in] from Source room.
- * @param[in] to Destination room.
+ * @param[in] from Source room index.
+ * @param[in] to Destination room index.
  */
-void log_ghost_move(int id, int boredom, const char* from, const char* to);
+void log_ghost_move(int id, int boredom, int from, int to);
 
 /**
  * @brief Append an EVIDENCE entry for the ghost.
  * @param[in] id Ghost identifier.
  * @param[in] boredom Current boredom level.
- * @param[in] room Room where evidence was dropped.
+ * @param[in] room Index of the room where evidence was dropped.
  * @param[in] evidence Evidence type left behind.
  */
-void log_ghost_evidence(int id, int boredom, const char* room, enum EvidenceType evidence);
+void log_ghost_evidence(int id, int boredom, int room, enum EvidenceType evidence);
 
 /**
  * @brief Append an EXIT entry for the ghost.
  * @param[in] id Ghost identifier.
  * @param[in] boredom Current boredom level.
- * @param[in] room Room the ghost leaves from.
+ * @param[in] room Index of the room the ghost leaves from.
  */
-void log_ghost_exit(int id, int boredom, const char* room);
+void log_ghost_exit(int id, int boredom, int room);
 
 /**
  * @brief Append an IDLE entry for the ghost.
  * @param[in] id Ghost identifier.
  * @param[in] boredom Current boredom level.
- * @param[in] room Room the ghost stays in.
+ * @param[in] room Index of the room the ghost stays in.
  */
-void log_ghost_idle(int id, int boredom, const char* room);
+void log_ghost_idle(int id, int boredom, int room);
 
 /**
  * @brief Append a RETURN entry for the hunter.
  * @param[in] id Hunter identifier.
  * @param[in] boredom Current boredom level.
  * @param[in] fear Current fear level.
- * @param[in] room Room the hunter is currently in.
+ * @param[in] room Index of the room the hunter is currently in.
  * @param[in] device Device being carried.
  * @param[in] heading_home true if beginning the return path.
  */
-void log_return_to_van(int id, int boredom, int fear, const char* room, enum EvidenceType device, bool heading_home);
+void log_return_to_van(int id, int boredom, int fear, int room, enum EvidenceType device, bool heading_home);
 
 /**
  * @brief Append an INIT entry for a hunter.
  * @param[in] id Hunter identifier.
- * @param[in] room Starting room.
+ * @param[in] room Starting room index.
  * @param[in] name Hunter name.
  * @param[in] device Initial device.
  */
-void log_hunter_init(int id, const char* room, const char* name, enum EvidenceType device);
+void log_hunter_init(int id, int room, const char* name, enum EvidenceType device);
 
 /**
  * @brief Append an INIT entry for the ghost.
  * @param[in] id Ghost identifier.
- * @param[in] room Starting room.
+ * @param[in] room Starting room index.
  * @param[in] type Ghost type.
  */
-void log_ghost_init(int id, const char* room, enum GhostType type);
+void log_ghost_init(int id, int room, enum GhostType type);
 
 #endif // HELPERS_H
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include "defs.h"
+#include "helpers.h"
+#include "console.h"
+#include "batch.h"
+#include "layout.h"
+
+#ifdef CACHE_ALIGN_LAYOUT
+#define LAYOUT_NAME "aligned"
+#else
+#define LAYOUT_NAME "packed"
+#endif
+
+#define HOUSEBENCH_MAX_HUNTERS 64
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--runs=N] [--engine=ENGINE] [--seed=N] [--generate=SHAPE:ROOMS[:SEED]]\n"
+            "Runs simulations with 1 to %d hunters and reports moves per second for this build's layout.\n"
+            "  --runs=N         simulations per hunter count (default 200)\n"
+            "  --engine=ENGINE  threads, pool, events or soa (default pool)\n"
+            "  --seed=N         master seed (default 1)\n"
+            "  --generate=SPEC  generated house (tree, grid, small-world or corridor) instead of Willow\n",
+            program, HOUSEBENCH_MAX_HUNTERS);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    static const struct option long_options[] = {
+        {"runs",     required_argument, NULL, 'n'},
+        {"engine",   required_argument, NULL, 'e'},
+        {"seed",     required_argument, NULL, 's'},
+        {"generate", required_argument, NULL, 'g'},
+        {"help",     no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int runs = 200;
+    enum SimEngine engine = ENGINE_POOL;
+    unsigned long long seed = 1;
+    struct Layout generated = {0};
+    const struct Layout* layout = NULL; // Willow
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'n':
+                runs = (int)strtol(optarg, NULL, 10);
+                break;
+            case 'e':
+                if (strcmp(optarg, "threads") == 0) {
+                    engine = ENGINE_THREADS;
+                } else if (strcmp(optarg, "pool") == 0) {
+                    engine = ENGINE_POOL;
+                } else if (strcmp(optarg, "events") == 0) {
+                    engine = ENGINE_EVENTS;
+                } else if (strcmp(optarg, "soa") == 0) {
+                    engine = ENGINE_SOA;
+                } else {
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'g':
+                layout_free(&generated);
+                if (!layout_generate_spec(&generated, optarg)) {
+                    print_usage(argv[0]);
+                    return 1;
+                }
+                layout = &generated;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+    if (runs <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Only the agents are timed: no log files, no console lines
+    log_set_enabled(false);
+    console_set_verbosity(CONSOLE_SILENT);
+
+    struct HunterEntry* roster = roster_generate(HOUSEBENCH_MAX_HUNTERS);
+
+    static const char* engine_names[] = {"threads", "events", "pool", "soa", "lanes"};
+    printf("layout %s (room %zu bytes, hunter %zu bytes), %s engine, %d rooms, %d runs each\n",
+           LAYOUT_NAME, sizeof(struct Room), sizeof(struct Hunter),
+           engine_names[engine], layout ? layout->room_count : layout_willow()->room_count, runs);
+    printf("%-8s %10s %12s %14s\n", "hunters", "seconds", "moves", "moves/s");
+
+    for (int hunters = 1; hunters <= HOUSEBENCH_MAX_HUNTERS; hunters *= 2) {
+        struct BatchStats stats;
+        double start = now_seconds();
+        batch_run(roster, hunters, runs, 1, seed, engine, 0, layout, &stats);
+        double elapsed = now_seconds() - start;
+
+        long long moves = stats.hunter_moves + stats.ghost_moves;
+        printf("%-8d %10.3f %12lld %14.0f\n", hunters, elapsed, moves, (double)moves / elapsed);
+    }
+
+    free(roster);
+    layout_free(&generated);
+    return 0;
+}
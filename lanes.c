@@ -0,0 +1,259 @@
+#include <stdlib.h>
+#include <string.h>
+#include "lanes.h"
+#include "helpers.h"
+
+// One 32-bit value per house; comparisons give -1 (true) or 0 per lane
+typedef int32_t lane_t __attribute__((vector_size(LANES_WIDTH * sizeof(int32_t))));
+typedef uint32_t ulane_t __attribute__((vector_size(LANES_WIDTH * sizeof(uint32_t))));
+typedef uint64_t wide_t __attribute__((vector_size(LANES_WIDTH * sizeof(uint64_t))));
+
+#define LANE_INLINE static inline __attribute__((always_inline))
+
+// xoshiro128** in every lane
+struct LaneRng {
+    ulane_t s[4];
+};
+
+// Hunters of all lanes, hunter-major
+struct LaneHunters {
+    lane_t* room;
+    lane_t* fear;
+    lane_t* boredom;
+    lane_t* moves;
+    lane_t* active; // -1 while in the house
+    lane_t* reason; // enum LogReason once gone
+};
+
+LANE_INLINE lane_t lane_splat(int32_t value) {
+    return (lane_t){0} + value;
+}
+
+LANE_INLINE lane_t lane_select(lane_t mask, lane_t a, lane_t b) {
+    return (a & mask) | (b & ~mask);
+}
+
+LANE_INLINE bool lane_any(lane_t mask) {
+    for (int i = 0; i < LANES_WIDTH; i++) {
+        if (mask[i]) return true;
+    }
+    return false;
+}
+
+// Per-lane table lookup (vpgatherdd where available)
+LANE_INLINE lane_t lane_gather(const int32_t* table, lane_t index) {
+    lane_t out;
+    for (int i = 0; i < LANES_WIDTH; i++) out[i] = table[index[i]];
+    return out;
+}
+
+LANE_INLINE ulane_t lane_rotl(ulane_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+LANE_INLINE ulane_t rng_lane_next(struct LaneRng* rng) {
+    ulane_t* s = rng->s;
+    ulane_t result = lane_rotl(s[1] * 5, 7) * 9;
+    ulane_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = lane_rotl(s[3], 11);
+    return result;
+}
+
+// Random value in [0, span) per lane by multiply-shift; spans here are tiny,
+// so the bias left by skipping Lemire's rejection step is below 2^-28
+LANE_INLINE lane_t rng_lane_range(struct LaneRng* rng, lane_t span) {
+    wide_t product = __builtin_convertvector(rng_lane_next(rng), wide_t) * __builtin_convertvector((ulane_t)span, wide_t);
+    return __builtin_convertvector(product >> 32, lane_t);
+}
+
+bool lanes_map_init(struct LaneMap* map, const struct House* house) {
+    memset(map, 0, sizeof(*map));
+    if (house->room_count > LANES_MAX_ROOMS) return false;
+    for (int r = 0; r < house->room_count; r++) {
+        if (house->rooms[r].connectionCount > LANES_MAX_DEGREE) return false;
+    }
+
+    map->room_count = house->room_count;
+    map->start = house->starting_room->index;
+
+    for (int r = 0; r < house->room_count; r++) {
+        const struct Room* room = &house->rooms[r];
+        map->exit[r] = room->exitRoom ? -1 : 0;
+        map->degree[r] = room->connectionCount;
+        for (int c = 0; c < LANES_MAX_DEGREE; c++) {
+            // Unused slots point back at the room, so masked lanes always read a valid index
+            map->next[r * LANES_MAX_DEGREE + c] = c < room->connectionCount ? room->connected[c] : r;
+        }
+    }
+
+    for (int r = 0; r < house->room_count; r++) {
+        int distance = house->routes.home_distance[r];
+        map->home_distance[r] = distance > 0 ? distance : 0; // Unreachable: nothing to walk
+    }
+
+    for (int mask = 0; mask < EVIDENCE_MASKS; mask++) {
+        map->solved[mask] = ghost_deduce((EvidenceByte)mask)->solved ? -1 : 0;
+    }
+    return true;
+}
+
+// One ghost_step() in the lanes of mask; clears ghost_active where the ghost leaves
+LANE_INLINE void ghost_turn(const struct LaneMap* map, struct LaneRng* rng, lane_t mask, lane_t* ghost_active,
+                            lane_t* ghost_room, lane_t* ghost_boredom, lane_t* ghost_moves, lane_t* evidence) {
+    const enum EvidenceType* devices;
+    int device_count = get_all_evidence_types(&devices);
+    int32_t device_table[8];
+    for (int i = 0; i < device_count && i < 8; i++) device_table[i] = devices[i];
+
+    lane_t leaving = mask & (*ghost_boredom >= ENTITY_BOREDOM_MAX);
+    *ghost_active &= ~leaving;
+    mask &= ~leaving;
+
+    // Drop evidence one time in six
+    lane_t drop = mask & (rng_lane_range(rng, lane_splat(6)) == 0);
+    lane_t kind = lane_gather(device_table, rng_lane_range(rng, lane_splat(device_count)));
+    for (int r = 0; r < map->room_count; r++) {
+        evidence[r] |= kind & drop & (*ghost_room == r);
+    }
+
+    lane_t degree = lane_gather(map->degree, *ghost_room);
+    lane_t moving = mask & (degree > 0);
+    lane_t slot = rng_lane_range(rng, degree);
+    lane_t next = lane_gather(map->next, *ghost_room * LANES_MAX_DEGREE + slot);
+    *ghost_room = lane_select(moving, next, *ghost_room);
+    *ghost_moves -= moving;
+    *ghost_boredom -= mask;
+}
+
+// One turn of every hunter in every lane, phase by phase as in the soa engine
+LANE_INLINE void hunters_turn(const struct LaneMap* map, struct LaneRng* rng, int hunter_count,
+                              struct LaneHunters* hunters, lane_t ghost_room, lane_t ghost_type,
+                              lane_t* collected, lane_t* evidence) {
+    // Evidence collection
+    for (int h = 0; h < hunter_count; h++) {
+        for (int r = 0; r < map->room_count; r++) {
+            lane_t here = hunters->active[h] & (hunters->room[h] == r);
+            *collected |= evidence[r] & here;
+            evidence[r] &= ~here;
+        }
+    }
+    lane_t solved = lane_gather(map->solved, *collected);
+
+    // Fear and boredom exits
+    for (int h = 0; h < hunter_count; h++) {
+        lane_t afraid = hunters->active[h] & (hunters->fear[h] >= HUNTER_FEAR_MAX);
+        lane_t bored = hunters->active[h] & ~afraid & (hunters->boredom[h] >= ENTITY_BOREDOM_MAX);
+        hunters->reason[h] = lane_select(afraid, lane_splat(LR_AFRAID), hunters->reason[h]);
+        hunters->reason[h] = lane_select(bored, lane_splat(LR_BORED), hunters->reason[h]);
+        hunters->active[h] &= ~(afraid | bored);
+    }
+
+    // Solved case: take the shortest route back to the van, charging its length from the home_distance table
+    for (int h = 0; h < hunter_count; h++) {
+        lane_t home = hunters->active[h] & solved;
+        hunters->moves[h] += lane_gather(map->home_distance, hunters->room[h]) & home;
+        hunters->room[h] = lane_select(home, lane_splat(map->start), hunters->room[h]);
+        hunters->reason[h] = lane_select(home, lane_splat(LR_EVIDENCE), hunters->reason[h]);
+        hunters->active[h] &= ~home;
+    }
+
+    // Fear where the ghost is, boredom elsewhere
+    for (int h = 0; h < hunter_count; h++) {
+        lane_t here = hunters->active[h] & (hunters->room[h] == ghost_room);
+        hunters->fear[h] -= here;
+        hunters->boredom[h] = ~here & (hunters->boredom[h] - hunters->active[h]);
+    }
+
+    // Leave through the exit with a full match, otherwise move
+    lane_t matched = (*collected & ghost_type) == ghost_type;
+    for (int h = 0; h < hunter_count; h++) {
+        lane_t at_exit = hunters->active[h] & lane_gather(map->exit, hunters->room[h]);
+        lane_t leaving = at_exit & matched;
+        hunters->reason[h] = lane_select(leaving, lane_splat(LR_EVIDENCE), hunters->reason[h]);
+        hunters->active[h] &= ~leaving;
+
+        lane_t degree = lane_gather(map->degree, hunters->room[h]);
+        lane_t moving = hunters->active[h] & (degree > 0);
+        lane_t slot = rng_lane_range(rng, degree);
+        lane_t next = lane_gather(map->next, hunters->room[h] * LANES_MAX_DEGREE + slot);
+        hunters->room[h] = lane_select(moving, next, hunters->room[h]);
+        hunters->moves[h] -= moving;
+    }
+}
+
+__attribute__((target_clones("avx2", "default")))
+void lanes_simulate(const struct LaneMap* map, int hunter_count, const uint64_t* seeds, int lanes,
+                    struct LaneOutcome* outcomes) {
+    const enum GhostType* types;
+    int type_count = get_all_ghost_types(&types);
+    int32_t* type_table = malloc(sizeof(int32_t) * type_count);
+    for (int i = 0; i < type_count; i++) type_table[i] = types[i];
+
+    // Expand each lane's seed into its xoshiro128** state
+    struct LaneRng rng;
+    lane_t live = lane_splat(0);
+    for (int i = 0; i < LANES_WIDTH; i++) {
+        uint64_t state = i < lanes ? seeds[i] : seeds[0];
+        for (int w = 0; w < 4; w++) {
+            state = rng_derive(state, RNG_STREAM_RUN, w);
+            rng.s[w][i] = (uint32_t)(state >> 32) | (w == 0); // Never all zero
+        }
+        live[i] = i < lanes ? -1 : 0;
+    }
+
+    lane_t ghost_type = lane_gather(type_table, rng_lane_range(&rng, lane_splat(type_count)));
+    lane_t ghost_room = rng_lane_range(&rng, lane_splat(map->room_count));
+    lane_t ghost_boredom = lane_splat(0);
+    lane_t ghost_moves = lane_splat(0);
+    lane_t ghost_active = live;
+    lane_t collected = lane_splat(0);
+    lane_t evidence[LANES_MAX_ROOMS];
+    for (int r = 0; r < LANES_MAX_ROOMS; r++) evidence[r] = lane_splat(0);
+
+    int slots = hunter_count > 0 ? hunter_count : 1;
+    lane_t* block = aligned_alloc(sizeof(lane_t), sizeof(lane_t) * 6 * slots);
+    struct LaneHunters hunters = {
+        .room = block, .fear = block + slots, .boredom = block + 2 * slots,
+        .moves = block + 3 * slots, .active = block + 4 * slots, .reason = block + 5 * slots
+    };
+    for (int h = 0; h < hunter_count; h++) {
+        hunters.room[h] = lane_splat(map->start);
+        hunters.fear[h] = hunters.boredom[h] = hunters.moves[h] = lane_splat(0);
+        hunters.active[h] = live;
+        hunters.reason[h] = lane_splat(LR_EVIDENCE);
+    }
+
+    for (;;) {
+        lane_t running = ghost_active;
+        for (int h = 0; h < hunter_count; h++) running |= hunters.active[h];
+        if (!lane_any(running)) break;
+
+        lane_t ghost_first = rng_lane_range(&rng, lane_splat(2)) == 0;
+        ghost_turn(map, &rng, ghost_active & ghost_first, &ghost_active,
+                   &ghost_room, &ghost_boredom, &ghost_moves, evidence);
+        hunters_turn(map, &rng, hunter_count, &hunters, ghost_room, ghost_type, &collected, evidence);
+        ghost_turn(map, &rng, ghost_active & ~ghost_first, &ghost_active,
+                   &ghost_room, &ghost_boredom, &ghost_moves, evidence);
+    }
+
+    for (int i = 0; i < lanes; i++) {
+        struct LaneOutcome* out = &outcomes[i];
+        memset(out, 0, sizeof(*out));
+        out->ghost = (enum GhostType)ghost_type[i];
+        out->ghost_moves = ghost_moves[i];
+        for (int h = 0; h < hunter_count; h++) {
+            int reason = hunters.reason[h][i];
+            out->exit_reasons[reason]++;
+            out->hunter_moves += hunters.moves[h][i];
+            if (reason == LR_EVIDENCE) out->hunters_win = true;
+        }
+    }
+
+    free(block);
+    free(type_table);
+}
@@ -0,0 +1,58 @@
+#ifndef LANES_H
+#define LANES_H
+
+#include <stdint.h>
+#include "defs.h"
+#include "helpers.h"
+
+#define LANES_WIDTH 8 // Houses advanced together, one per 32-bit vector lane
+#define LANES_MAX_ROOMS 24 // Largest layout the lanes engine runs (it scans every room per hunter turn)
+#define LANES_MAX_DEGREE 8 // Most connections of one room
+
+// Read-only room graph shared by every lane
+struct LaneMap {
+    int room_count; // Rooms in use
+    int32_t start; // Room index the hunters start in (the van)
+    int32_t exit[LANES_MAX_ROOMS]; // -1 for exit rooms, 0 otherwise
+    int32_t degree[LANES_MAX_ROOMS]; // Connections per room
+    int32_t next[LANES_MAX_ROOMS * LANES_MAX_DEGREE]; // Neighbours, row-major by room
+    int32_t home_distance[LANES_MAX_ROOMS]; // Moves back to start along the house's shortest route
+    int32_t solved[EVIDENCE_MASKS]; // Per case-file mask: -1 where ghost_deduce() says the case is solved
+};
+
+// What one lane's run ended with
+struct LaneOutcome {
+    enum GhostType ghost; // Ghost type of the run
+    bool hunters_win; // A hunter left with the evidence
+    int exit_reasons[3]; // Hunter exits per enum LogReason
+    int hunter_moves; // Hunter room changes
+    int ghost_moves; // Ghost room changes
+};
+
+/**
+ * @brief Build the shared room graph from a populated house.
+ * @param[out] map Graph to fill.
+ * @param[in] house House after house_build_layout().
+ * @return false when the layout has more than LANES_MAX_ROOMS rooms or a room
+ *         with more than LANES_MAX_DEGREE connections.
+ */
+bool lanes_map_init(struct LaneMap* map, const struct House* house);
+
+/**
+ * @brief Run up to LANES_WIDTH independent simulations side by side.
+ * @param[in] map Shared room graph.
+ * @param[in] hunter_count Hunters in every house.
+ * @param[in] seeds Seed of each lane's run.
+ * @param[in] lanes Lanes in use (1..LANES_WIDTH); the rest are masked off.
+ * @param[out] outcomes Result of each lane in use.
+ *
+ * Every lane holds one house: room evidence, ghost room, boredom and type,
+ * the case file mask and per-hunter room, fear and boredom. Turns follow the soa engine (ghost before or after the hunters,
+ * hunter phases in hunter_step() order) and are computed for all lanes at
+ * once with vector operations; finished lanes are masked out until the
+ * last one is done. Nothing is logged.
+ */
+void lanes_simulate(const struct LaneMap* map, int hunter_count, const uint64_t* seeds, int lanes,
+                    struct LaneOutcome* outcomes);
+
+#endif // LANES_H
@@ -0,0 +1,405 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "layout.h"
+
+// ---- Willow ----
+
+// Willow House layout from Phasmaphobia, DO NOT MODIFY HOUSE LAYOUT
+static char willow_names[][MAX_ROOM_NAME] = {
+    "Van", "Hallway", "Master Bedroom", "Boy's Bedroom", "Bathroom", "Basement", "Basement Hallway",
+    "Right Storage Room", "Left Storage Room", "Kitchen", "Living Room", "Garage", "Utility Room"
+};
+
+static bool willow_exits[] = {
+    true, false, false, false, false, false, false, false, false, false, false, false, false
+};
+
+static int willow_edges[] = {
+    0, 1,    // Van - Hallway
+    1, 2,    // Hallway - Master Bedroom
+    1, 3,    // Hallway - Boy's Bedroom
+    1, 4,    // Hallway - Bathroom
+    1, 9,    // Hallway - Kitchen
+    1, 5,    // Hallway - Basement
+    5, 6,    // Basement - Basement Hallway
+    6, 7,    // Basement Hallway - Right Storage Room
+    6, 8,    // Basement Hallway - Left Storage Room
+    9, 10,   // Kitchen - Living Room
+    9, 11,   // Kitchen - Garage
+    11, 12,  // Garage - Utility Room
+};
+
+static const struct Layout willow = {
+    .room_count = 13,
+    .names = willow_names,
+    .exits = willow_exits,
+    .start = 0, // Van
+    .edge_count = 12,
+    .edges = willow_edges
+};
+
+const struct Layout* layout_willow(void) {
+    return &willow;
+}
+
+// ---- Loading ----
+
+// Append a room, doubling the arrays when full
+static void layout_add_room(struct Layout* layout, const char* name, bool is_exit) {
+    if (layout->room_count == layout->room_capacity) {
+        layout->room_capacity = (layout->room_capacity == 0 ? 16 : layout->room_capacity * 2);
+        layout->names = realloc(layout->names, layout->room_capacity * sizeof(*layout->names));
+        layout->exits = realloc(layout->exits, layout->room_capacity * sizeof(bool));
+    }
+
+    strncpy(layout->names[layout->room_count], name, MAX_ROOM_NAME - 1);
+    layout->names[layout->room_count][MAX_ROOM_NAME - 1] = '\0';
+    layout->exits[layout->room_count] = is_exit;
+    layout->room_count++;
+}
+
+// Append a connection, doubling the array when full
+static void layout_add_edge(struct Layout* layout, int a, int b) {
+    if (layout->edge_count == layout->edge_capacity) {
+        layout->edge_capacity = (layout->edge_capacity == 0 ? 16 : layout->edge_capacity * 2);
+        layout->edges = realloc(layout->edges, layout->edge_capacity * 2 * sizeof(int));
+    }
+
+    layout->edges[2 * layout->edge_count] = a;
+    layout->edges[2 * layout->edge_count + 1] = b;
+    layout->edge_count++;
+}
+
+// Connections added so far, one list per room, so no pair of rooms is connected twice:
+// a repeated connection would appear twice in a CSR row and bias moves toward that room
+struct EdgeIndex {
+    int rooms; // Rooms with a list
+    int* head; // First entry of each room's list, -1 when empty
+    int* degree; // Entries in each room's list
+    int entries; // Entries used
+    int entry_capacity; // Entries allocated
+    int* next; // Next entry of the same room
+    int* other; // Room at the far end of the entry
+};
+
+// Give rooms [index->rooms, rooms) empty lists
+static void edge_index_reserve(struct EdgeIndex* index, int rooms) {
+    if (rooms <= index->rooms) return;
+    index->head = realloc(index->head, rooms * sizeof(int));
+    index->degree = realloc(index->degree, rooms * sizeof(int));
+    for (int r = index->rooms; r < rooms; r++) {
+        index->head[r] = -1;
+        index->degree[r] = 0;
+    }
+    index->rooms = rooms;
+}
+
+// Scan the shorter of the two lists
+static bool edge_index_has(const struct EdgeIndex* index, int a, int b) {
+    if (index->degree[b] < index->degree[a]) {
+        int swap = a;
+        a = b;
+        b = swap;
+    }
+    for (int e = index->head[a]; e >= 0; e = index->next[e]) {
+        if (index->other[e] == b) return true;
+    }
+    return false;
+}
+
+static void edge_index_push(struct EdgeIndex* index, int from, int to) {
+    if (index->entries == index->entry_capacity) {
+        index->entry_capacity = (index->entry_capacity == 0 ? 32 : index->entry_capacity * 2);
+        index->next = realloc(index->next, index->entry_capacity * sizeof(int));
+        index->other = realloc(index->other, index->entry_capacity * sizeof(int));
+    }
+    index->other[index->entries] = to;
+    index->next[index->entries] = index->head[from];
+    index->head[from] = index->entries++;
+    index->degree[from]++;
+}
+
+// Connect a and b unless they already are; false for a repeat
+static bool layout_add_unique_edge(struct Layout* layout, struct EdgeIndex* index, int a, int b) {
+    if (edge_index_has(index, a, b)) return false;
+    edge_index_push(index, a, b);
+    edge_index_push(index, b, a);
+    layout_add_edge(layout, a, b);
+    return true;
+}
+
+static void edge_index_free(struct EdgeIndex* index) {
+    free(index->head);
+    free(index->degree);
+    free(index->next);
+    free(index->other);
+}
+
+// Strip leading and trailing blanks in place
+static char* trim(char* text) {
+    while (isspace((unsigned char)*text)) text++;
+    char* end = text + strlen(text);
+    while (end > text && isspace((unsigned char)end[-1])) end--;
+    *end = '\0';
+    return text;
+}
+
+// One directive; false on a malformed line
+static bool layout_parse_line(struct Layout* layout, struct EdgeIndex* index, char* line) {
+    char* comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+    line = trim(line);
+    if (*line == '\0') return true;
+
+    char* rest = line;
+    while (*rest && !isspace((unsigned char)*rest)) rest++;
+    if (*rest) *rest++ = '\0';
+    rest = trim(rest);
+
+    if (strcmp(line, "room") == 0 || strcmp(line, "exit") == 0) {
+        if (*rest == '\0' || strlen(rest) >= MAX_ROOM_NAME) return false;
+        layout_add_room(layout, rest, line[0] == 'e');
+        return true;
+    }
+
+    if (strcmp(line, "edge") == 0) {
+        int a, b;
+        char extra;
+        if (sscanf(rest, "%d %d %c", &a, &b, &extra) != 2) return false;
+        // Rooms must be listed before they are connected
+        if (a < 0 || b < 0 || a >= layout->room_count || b >= layout->room_count || a == b) return false;
+        edge_index_reserve(index, layout->room_count);
+        return layout_add_unique_edge(layout, index, a, b); // Listing a connection twice is an error
+
+    }
+
+    if (strcmp(line, "start") == 0) {
+        char extra;
+        if (sscanf(rest, "%d %c", &layout->start, &extra) != 1) return false;
+        return layout->start >= 0;
+    }
+
+    return false;
+}
+
+bool layout_load(struct Layout* layout, const char* path) {
+    memset(layout, 0, sizeof(*layout));
+
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    int number = 0;
+    bool ok = true;
+    struct EdgeIndex index = {0};
+    while (ok && fgets(line, sizeof(line), file)) {
+        number++;
+        if (!strchr(line, '\n') && !feof(file)) {
+            fprintf(stderr, "%s:%d: line too long\n", path, number);
+            ok = false;
+        } else if (!layout_parse_line(layout, &index, line)) {
+            fprintf(stderr, "%s:%d: invalid layout line\n", path, number);
+            ok = false;
+        }
+    }
+    fclose(file);
+    edge_index_free(&index);
+
+    if (ok && layout->room_count == 0) {
+        fprintf(stderr, "%s: layout has no rooms\n", path);
+        ok = false;
+    }
+    if (ok && layout->start >= layout->room_count) {
+        fprintf(stderr, "%s: start room %d does not exist\n", path, layout->start);
+        ok = false;
+    }
+
+    if (!ok) layout_free(layout);
+    return ok;
+}
+
+void layout_free(struct Layout* layout) {
+    free(layout->names);
+    free(layout->exits);
+    free(layout->edges);
+    memset(layout, 0, sizeof(*layout));
+}
+
+// ---- Generation ----
+
+void layout_generate(struct Layout* layout, enum LayoutShape shape, int room_count, uint64_t seed) {
+    memset(layout, 0, sizeof(*layout));
+    if (room_count < 1) room_count = 1;
+
+    // Sized once: no shape has more than two connections per room
+    layout->room_capacity = room_count;
+    layout->names = malloc(room_count * sizeof(*layout->names));
+    layout->exits = malloc(room_count * sizeof(bool));
+    layout->edge_capacity = 2 * room_count;
+    layout->edges = malloc(layout->edge_capacity * 2 * sizeof(int));
+
+    layout_add_room(layout, "Van", true);
+    for (int r = 1; r < room_count; r++) {
+        char name[MAX_ROOM_NAME];
+        snprintf(name, sizeof(name), "Room %d", r);
+        layout_add_room(layout, name, false);
+    }
+
+    struct Rng rng;
+    rng_seed(&rng, seed, RNG_STREAM_LAYOUT, shape);
+
+    switch (shape) {
+        case LAYOUT_TREE:
+            for (int r = 1; r < room_count; r++) {
+                layout_add_edge(layout, rng_range(&rng, 0, r), r);
+            }
+            break;
+
+        case LAYOUT_GRID: {
+            int side = 1;
+            while (side * side < room_count) side++;
+            for (int r = 0; r < room_count; r++) {
+                if ((r + 1) % side != 0 && r + 1 < room_count) layout_add_edge(layout, r, r + 1);
+                if (r + side < room_count) layout_add_edge(layout, r, r + side);
+            }
+            break;
+        }
+
+        case LAYOUT_SMALL_WORLD: {
+            // The ring links keep every room reachable; only the chords are rewired
+            struct EdgeIndex index = {0};
+            edge_index_reserve(&index, room_count);
+            for (int r = 0; r + 1 < room_count; r++) {
+                layout_add_unique_edge(layout, &index, r, r + 1);
+            }
+            if (room_count > 2) layout_add_unique_edge(layout, &index, room_count - 1, 0);
+            for (int r = 0; room_count > 4 && r < room_count; r++) {
+                int to = (r + 2) % room_count;
+                bool rewire = rng_range(&rng, 0, 10) == 0;
+                // Re-draw a chord that would repeat a connection; skip it if r already reaches every room
+                while ((rewire || edge_index_has(&index, r, to)) && index.degree[r] < room_count - 1) {
+                    to = rng_range(&rng, 0, room_count - 1);
+                    if (to >= r) to++; // Never the room itself
+                    rewire = false;
+                }
+                layout_add_unique_edge(layout, &index, r, to);
+            }
+            edge_index_free(&index);
+            break;
+        }
+
+        case LAYOUT_CORRIDOR:
+            for (int r = 0; r + 1 < room_count; r++) {
+                layout_add_edge(layout, r, r + 1);
+            }
+            break;
+    }
+}
+
+bool layout_generate_spec(struct Layout* layout, const char* spec) {
+    static const struct {
+        const char* name;
+        enum LayoutShape shape;
+    } shapes[] = {
+        {"tree", LAYOUT_TREE},
+        {"grid", LAYOUT_GRID},
+        {"small-world", LAYOUT_SMALL_WORLD},
+        {"corridor", LAYOUT_CORRIDOR}
+    };
+
+    const char* colon = strchr(spec, ':');
+    if (!colon) return false;
+
+    int shape = -1;
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+        if (strlen(shapes[i].name) == (size_t)(colon - spec) && strncmp(spec, shapes[i].name, colon - spec) == 0) {
+            shape = (int)shapes[i].shape;
+        }
+    }
+    if (shape < 0) return false;
+
+    char* end;
+    long rooms = strtol(colon + 1, &end, 10);
+    if (end == colon + 1 || rooms < 1 || rooms > 100000000) return false;
+
+    unsigned long long seed = 1;
+    if (*end == ':') {
+        const char* text = end + 1;
+        seed = strtoull(text, &end, 0);
+        if (end == text) return false;
+    }
+    if (*end != '\0') return false;
+
+    layout_generate(layout, (enum LayoutShape)shape, (int)rooms, seed);
+    return true;
+}
+
+// ---- Houses ----
+
+void house_build_layout(struct House* house, const struct Layout* layout) {
+    int count = layout->room_count;
+    house->room_count = count;
+
+    // Rooms may start a cache line in the aligned layout, so allocate them aligned
+    size_t bytes = (size_t)count * sizeof(struct Room);
+    house->rooms = aligned_alloc(_Alignof(struct Room), bytes);
+    memset(house->rooms, 0, bytes);
+
+    // Count the neighbours of every room, then turn the counts into row offsets
+    house->adjacency_offsets = calloc(count + 1, sizeof(int));
+    for (int e = 0; e < 2 * layout->edge_count; e++) {
+        house->adjacency_offsets[layout->edges[e] + 1]++;
+    }
+    for (int r = 0; r < count; r++) {
+        house->adjacency_offsets[r + 1] += house->adjacency_offsets[r];
+    }
+    house->adjacency = malloc((2 * layout->edge_count + 1) * sizeof(int));
+
+    // Rooms know their own index and house, so logs can refer to them by number
+    for (int r = 0; r < count; r++) {
+        struct Room* room = &house->rooms[r];
+        room_init(room, layout->names[r], layout->exits[r]);
+        room->index = r;
+        room->home = house;
+        room->connected = house->adjacency + house->adjacency_offsets[r];
+    }
+
+    // Fill the rows in listing order, both directions of every connection
+    for (int e = 0; e < layout->edge_count; e++) {
+        int a = layout->edges[2 * e];
+        int b = layout->edges[2 * e + 1];
+        house->adjacency[house->adjacency_offsets[a] + house->rooms[a].connectionCount++] = b;
+        house->adjacency[house->adjacency_offsets[b] + house->rooms[b].connectionCount++] = a;
+    }
+
+    house->starting_room = &house->rooms[layout->start];
+
+    house_build_routes(house); // Shortest routes for hunters heading back to the start
+}
+
+void house_free_layout(struct House* house) {
+    for (int i = 0; i < house->room_count; i++) {
+        sem_destroy(&house->rooms[i].mutex);
+        free(house->rooms[i].occupants.hunters);
+    }
+    free(house->rooms);
+    free(house->adjacency);
+    free(house->adjacency_offsets);
+    house->rooms = NULL;
+    house->adjacency = NULL;
+    house->adjacency_offsets = NULL;
+    house->room_count = 0;
+    house->starting_room = NULL;
+
+    struct RouteTable* routes = &house->routes;
+    free(routes->next_hop);
+    free(routes->distance);
+    free(routes->home_hop);
+    free(routes->home_distance);
+    memset(routes, 0, sizeof(*routes));
+}
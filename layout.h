@@ -0,0 +1,89 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "defs.h"
+
+// Room graph a house is built from; rooms are numbered in the order they are listed
+struct Layout {
+    int room_count; // Rooms listed
+    int room_capacity; // Allocated room slots
+    char (*names)[MAX_ROOM_NAME]; // Room names
+    bool* exits; // True for exit rooms
+    int start; // Room the hunters start in (the van)
+    int edge_count; // Connections listed
+    int edge_capacity; // Allocated connection slots
+    int* edges; // Room index pairs, 2 * edge_count entries; every connection goes both ways
+};
+
+// Topologies layout_generate() can build
+enum LayoutShape {
+    LAYOUT_TREE = 0,      // Random recursive tree: every room hangs off a random earlier one
+    LAYOUT_GRID,          // Square grid, rows filled left to right; the last row may be short
+    LAYOUT_SMALL_WORLD,   // Ring where every room also links two rooms ahead, a tenth of those links rewired at random
+    LAYOUT_CORRIDOR       // One long chain of rooms
+};
+
+/**
+ * @brief Built-in Willow layout (13 rooms, the van at index 0).
+ * @return Shared read-only layout; never free it.
+ */
+const struct Layout* layout_willow(void);
+
+/**
+ * @brief Read a text layout file.
+ * @param[out] layout Layout to fill; release it with layout_free().
+ * @param[in] path File to read.
+ * @return true on success; false after printing the offending line to stderr.
+ *
+ * One directive per line, '#' starts a comment:
+ *   room NAME    next room, not an exit (NAME is the rest of the line)
+ *   exit NAME    next room, an exit
+ *   edge A B     connect rooms A and B (indices from 0, each pair at most once)
+ *   start N      hunters start in room N (default 0)
+ */
+bool layout_load(struct Layout* layout, const char* path);
+
+/**
+ * @brief Build a layout procedurally.
+ * @param[out] layout Layout to fill; release it with layout_free().
+ * @param[in] shape Topology.
+ * @param[in] room_count Rooms to create (at least 1).
+ * @param[in] seed Seed of the random choices; the same shape, size and seed give the same layout.
+ *
+ * Room 0 is the "Van": the only exit and the starting room, at the root of
+ * the tree, a corner of the grid and one end of the corridor. Every layout is connected.
+ */
+void layout_generate(struct Layout* layout, enum LayoutShape shape, int room_count, uint64_t seed);
+
+/**
+ * @brief Build a layout from a SHAPE:ROOMS[:SEED] specification.
+ * @param[out] layout Layout to fill; release it with layout_free().
+ * @param[in] spec Shape (tree, grid, small-world or corridor), room count and optional seed (default 1).
+ * @return false on a malformed specification.
+ */
+bool layout_generate_spec(struct Layout* layout, const char* spec);
+
+/**
+ * @brief Free a layout filled by layout_load() or layout_generate().
+ * @param[in,out] layout Layout to release.
+ */
+void layout_free(struct Layout* layout);
+
+/**
+ * @brief Give a house the rooms of a layout.
+ * @param[in,out] house Zeroed house; rooms, adjacency and routes are allocated.
+ * @param[in] layout Room graph to build.
+ *
+ * Neighbours are stored in compressed sparse row form: room i's neighbour
+ * indices are adjacency[adjacency_offsets[i] .. adjacency_offsets[i + 1]),
+ * in the order the connections were listed.
+ */
+void house_build_layout(struct House* house, const struct Layout* layout);
+
+/**
+ * @brief Destroy the room semaphores and free what house_build_layout() allocated.
+ * @param[in,out] house House whose rooms are released.
+ */
+void house_free_layout(struct House* house);
+
+#endif // LAYOUT_H
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include "logsink.h"
+
+// Line shaped like a real MOVE record
+static const char sample_line[] = "1792257161689,hunter,1,Master Bedroom,temp,4,2,MOVE,Hallway\n";
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--records=N] [--entities=N] [--dir=DIR]\n"
+            "Appends the same CSV lines through every log sink backend and reports their throughput.\n"
+            "  --records=N   lines written per backend (default 2000000)\n"
+            "  --entities=N  log files the lines are spread over (default 16)\n"
+            "  --dir=DIR     scratch directory for the log files (default: a new directory in /tmp)\n",
+            program);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void remove_logs(int entities) {
+    char path[64];
+    for (int id = 0; id < entities; id++) {
+        snprintf(path, sizeof(path), "log_%d.csv", id);
+        unlink(path);
+    }
+}
+
+// Write every line, close the sinks (so mapped files are trimmed) and return the elapsed time;
+// negative when the backend is not available on this host
+static double run_backend(enum LogSinkBackend backend, long records, int entities) {
+    remove_logs(entities);
+    logsink_configure("csv", NULL, 0);
+    if (!logsink_set_backend(backend)) {
+        return -1.0;
+    }
+
+    double start = now_seconds();
+    for (long i = 0; i < records; i++) {
+        logsink_write((int)(i % entities), sample_line, sizeof(sample_line) - 1);
+    }
+    logsink_close_all();
+    double elapsed = now_seconds() - start;
+
+    remove_logs(entities);
+    return elapsed;
+}
+
+int main(int argc, char** argv) {
+    static const struct option long_options[] = {
+        {"records",  required_argument, NULL, 'r'},
+        {"entities", required_argument, NULL, 'e'},
+        {"dir",      required_argument, NULL, 'd'},
+        {"help",     no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    long records = 2000000;
+    int entities = 16;
+    const char* directory = NULL;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'r':
+                records = strtol(optarg, NULL, 10);
+                break;
+            case 'e':
+                entities = (int)strtol(optarg, NULL, 10);
+                break;
+            case 'd':
+                directory = optarg;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+    if (records <= 0 || entities <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    char scratch[] = "/tmp/ghostbench.XXXXXX";
+    if (!directory) {
+        directory = mkdtemp(scratch);
+        if (!directory) {
+            perror("mkdtemp");
+            return 1;
+        }
+    }
+    if (chdir(directory) != 0) {
+        perror(directory);
+        return 1;
+    }
+
+    static const struct {
+        const char* name;
+        enum LogSinkBackend backend;
+    } backends[] = {
+        {"write",    LOGSINK_BACKEND_WRITE},
+        {"mmap",     LOGSINK_BACKEND_MMAP},
+        {"io_uring", LOGSINK_BACKEND_URING},
+    };
+
+    double megabytes = (double)records * (sizeof(sample_line) - 1) / (1024.0 * 1024.0);
+    printf("%ld lines (%.1f MiB) over %d files\n", records, megabytes, entities);
+    printf("%-8s %10s %14s %10s\n", "backend", "seconds", "lines/s", "MiB/s");
+
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); i++) {
+        double elapsed = run_backend(backends[i].backend, records, entities);
+        if (elapsed < 0) {
+            printf("%-8s %10s\n", backends[i].name, "unavailable");
+            continue;
+        }
+        printf("%-8s %10.3f %14.0f %10.1f\n", backends[i].name, elapsed,
+               (double)records / elapsed, megabytes / elapsed);
+    }
+
+    if (directory == scratch) {
+        rmdir(scratch);
+    }
+    return 0;
+}
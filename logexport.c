@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "logformat.h"
+
+// Output file for the entity currently being exported
+struct ExportTarget {
+    int entity_id;
+    FILE* file;
+};
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--seq] [--output-dir=DIR] log_<id>.bin...\n"
+            "Expands binary ghost house logs into the log_<id>.csv files the simulation would have written.\n"
+            "  --seq             append the sequence number as a last column (like ghosthouse --log-seq)\n"
+            "  --output-dir=DIR  directory that receives the CSV files (default: current directory)\n",
+            program);
+}
+
+// Look up a table entry, falling back to the text the simulation prints for bad values
+static const char* table_entry(const char** table, unsigned count, unsigned index) {
+    return index < count ? table[index] : "unknown";
+}
+
+static const char* device_text(const struct LogBinaryTables* tables, unsigned code) {
+    if (code == LOGBIN_DEVICE_NONE) return "";
+    return table_entry(tables->evidence, tables->evidence_count, code);
+}
+
+static const char* extra_text(const struct LogBinaryTables* tables, const struct LogBinaryRecord* entry,
+                              const char* name, char* scratch, size_t size) {
+    switch (entry->action) {
+        case LOG_ACTION_INIT:
+            if (entry->entity_type == LOG_ENTITY_GHOST) {
+                return table_entry(tables->ghosts, tables->ghost_count, entry->extra);
+            }
+            return name;
+        case LOG_ACTION_MOVE:
+            return entry->extra < tables->room_count ? tables->rooms[entry->extra] : "";
+        case LOG_ACTION_EVIDENCE:
+            return device_text(tables, entry->extra);
+        case LOG_ACTION_SWAP:
+            snprintf(scratch, size, "%s->%s",
+                     device_text(tables, entry->extra),
+                     device_text(tables, entry->device));
+            return scratch;
+        case LOG_ACTION_EXIT:
+            if (entry->entity_type == LOG_ENTITY_HUNTER) {
+                return table_entry(tables->reasons, tables->reason_count, entry->extra);
+            }
+            return "";
+        case LOG_ACTION_RETURN_START:
+            return "start";
+        case LOG_ACTION_RETURN_COMPLETE:
+            return "complete";
+        default:
+            return "";
+    }
+}
+
+static FILE* target_for(struct ExportTarget* target, const char* directory, int entity_id) {
+    if (target->file && target->entity_id == entity_id) {
+        return target->file;
+    }
+    if (target->file) {
+        fclose(target->file);
+    }
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/log_%d.csv", directory, entity_id);
+    target->file = fopen(path, "a"); // Append, exactly like the simulation does
+    target->entity_id = entity_id;
+    if (!target->file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+    }
+    return target->file;
+}
+
+// Convert one binary log; returns false on a malformed file
+static bool export_file(const char* path, const char* directory, bool with_sequence) {
+    FILE* input = fopen(path, "rb");
+    if (!input) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return false;
+    }
+
+    struct LogBinaryTables tables;
+    if (!logbin_read_header(input, &tables)) {
+        fprintf(stderr, "%s is not a ghost house binary log\n", path);
+        logbin_free_tables(&tables);
+        fclose(input);
+        return false;
+    }
+
+    struct ExportTarget target = { .entity_id = 0, .file = NULL };
+    unsigned char bytes[LOGBIN_RECORD_SIZE];
+    bool ok = true;
+
+    for (;;) {
+        // Nothing left is the clean end; any other short read is a cut-off record
+        size_t got = fread(bytes, 1, LOGBIN_RECORD_SIZE, input);
+        if (got == 0 && !ferror(input)) break;
+        if (got != LOGBIN_RECORD_SIZE) {
+            ok = false;
+            break;
+        }
+
+        struct LogBinaryRecord entry;
+        logbin_decode_record(bytes, &entry);
+
+        // Hunter INIT records carry the hunter name right after the record
+        char name[LOGBIN_NAME_SIZE + 1] = "";
+        if (entry.action == LOG_ACTION_INIT && entry.entity_type == LOG_ENTITY_HUNTER) {
+            if (fread(name, 1, LOGBIN_NAME_SIZE, input) != LOGBIN_NAME_SIZE) {
+                ok = false;
+                break;
+            }
+            name[LOGBIN_NAME_SIZE] = '\0';
+        }
+
+        struct LogRecord record = {
+            .sequence = entry.sequence,
+            .timestamp = entry.timestamp,
+            .entity_id = entry.entity_id,
+            .boredom = entry.boredom,
+            .fear = entry.fear,
+            .entity_type = entry.entity_type,
+            .action = entry.action
+        };
+
+        char scratch[LOGBIN_NAME_SIZE * 2];
+        char line[512];
+        size_t length = log_format_csv(line, sizeof(line), &record,
+                                       entry.room < tables.room_count ? tables.rooms[entry.room] : "",
+                                       device_text(&tables, entry.device),
+                                       extra_text(&tables, &entry, name, scratch, sizeof(scratch)),
+                                       with_sequence);
+
+        FILE* output = target_for(&target, directory, entry.entity_id);
+        if (!output) {
+            ok = false;
+            break;
+        }
+        fwrite(line, 1, length, output);
+    }
+
+    if (!ok) fprintf(stderr, "%s: truncated or unreadable record\n", path);
+
+    if (target.file) fclose(target.file);
+    logbin_free_tables(&tables);
+    fclose(input);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    static const struct option long_options[] = {
+        {"seq",        no_argument,       NULL, 's'},
+        {"output-dir", required_argument, NULL, 'o'},
+        {"help",       no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    bool with_sequence = false;
+    const char* directory = ".";
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "o:h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 's':
+                with_sequence = true;
+                break;
+            case 'o':
+                directory = optarg;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int status = 0;
+    for (int i = optind; i < argc; i++) {
+        if (!export_file(argv[i], directory, with_sequence)) {
+            status = 1;
+        }
+    }
+    return status;
+}
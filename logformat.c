@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <string.h>
+#include "logformat.h"
+
+// ---- Column text ----
+const char* log_entity_type_to_string(enum LogEntityType type) {
+    switch (type) {
+        case LOG_ENTITY_HUNTER:
+            return "hunter";
+        case LOG_ENTITY_GHOST:
+            return "ghost";
+        default:
+            return "unknown";
+    }
+}
+
+const char* log_action_to_string(enum LogAction action) {
+    switch (action) {
+        case LOG_ACTION_INIT:
+            return "INIT";
+        case LOG_ACTION_MOVE:
+            return "MOVE";
+        case LOG_ACTION_EVIDENCE:
+            return "EVIDENCE";
+        case LOG_ACTION_SWAP:
+            return "SWAP";
+        case LOG_ACTION_EXIT:
+            return "EXIT";
+        case LOG_ACTION_IDLE:
+            return "IDLE";
+        case LOG_ACTION_RETURN_START:
+            return "RETURN_START";
+        case LOG_ACTION_RETURN_COMPLETE:
+            return "RETURN_COMPLETE";
+        default:
+            return "";
+    }
+}
+
+// ---- CSV ----
+size_t log_format_csv(char* line, size_t size, const struct LogRecord* record,
+                      const char* room, const char* device, const char* extra, bool with_sequence) {
+    int length = snprintf(line, size,
+                          "%lld,%s,%d,%s,%s,%d,%d,%s,%s",
+                          record->timestamp,
+                          log_entity_type_to_string((enum LogEntityType)record->entity_type),
+                          record->entity_id,
+                          room ? room : "",
+                          device ? device : "",
+                          record->boredom,
+                          record->fear,
+                          log_action_to_string((enum LogAction)record->action),
+                          extra ? extra : "");
+
+    // Opt-in trailing column so existing nine-column consumers keep working
+    if (length >= 0 && (size_t)length < size) {
+        if (with_sequence) {
+            length += snprintf(line + length, size - (size_t)length, ",%llu\n", record->sequence);
+        } else {
+            length += snprintf(line + length, size - (size_t)length, "\n");
+        }
+    }
+
+    if (length < 0) {
+        return 0;
+    }
+    if ((size_t)length >= size) {
+        length = (int)size - 1; // Keep the line terminated even if a field was absurdly long
+        line[length - 1] = '\n';
+    }
+    return (size_t)length;
+}
+
+// ---- Little-endian helpers ----
+static void put_u16(unsigned char* out, unsigned value) {
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+}
+
+static void put_u32(unsigned char* out, unsigned long value) {
+    for (int i = 0; i < 4; i++) out[i] = (unsigned char)((value >> (8 * i)) & 0xFF);
+}
+
+static void put_u64(unsigned char* out, unsigned long long value) {
+    for (int i = 0; i < 8; i++) out[i] = (unsigned char)((value >> (8 * i)) & 0xFF);
+}
+
+static unsigned get_u16(const unsigned char* in) {
+    return (unsigned)in[0] | ((unsigned)in[1] << 8);
+}
+
+static unsigned long get_u32(const unsigned char* in) {
+    unsigned long value = 0;
+    for (int i = 3; i >= 0; i--) value = (value << 8) | in[i];
+    return value;
+}
+
+static unsigned long long get_u64(const unsigned char* in) {
+    unsigned long long value = 0;
+    for (int i = 7; i >= 0; i--) value = (value << 8) | in[i];
+    return value;
+}
+
+// ---- Binary records ----
+// Offsets: 0 sequence, 8 timestamp, 16 id, 20 room, 24 extra, 28 boredom,
+//          32 fear, 36 entity type, 37 action, 38 device, 39 reserved
+void logbin_encode_record(const struct LogBinaryRecord* record, unsigned char* out) {
+    put_u64(out + 0, record->sequence);
+    put_u64(out + 8, (unsigned long long)record->timestamp);
+    put_u32(out + 16, (unsigned long)(unsigned)record->entity_id);
+    put_u32(out + 20, record->room);
+    put_u32(out + 24, record->extra);
+    put_u32(out + 28, (unsigned long)(unsigned)record->boredom);
+    put_u32(out + 32, (unsigned long)(unsigned)record->fear);
+    out[36] = record->entity_type;
+    out[37] = record->action;
+    out[38] = record->device;
+    out[39] = 0;
+}
+
+void logbin_decode_record(const unsigned char* in, struct LogBinaryRecord* record) {
+    record->sequence = get_u64(in + 0);
+    record->timestamp = (long long)get_u64(in + 8);
+    record->entity_id = (int)(unsigned)get_u32(in + 16);
+    record->room = (unsigned)get_u32(in + 20);
+    record->extra = (unsigned)get_u32(in + 24);
+    record->boredom = (int)(unsigned)get_u32(in + 28);
+    record->fear = (int)(unsigned)get_u32(in + 32);
+    record->entity_type = in[36];
+    record->action = in[37];
+    record->device = in[38];
+}
+
+// ---- Header ----
+static size_t table_size(const char* const* strings, unsigned count) {
+    size_t size = 4;
+    for (unsigned i = 0; i < count; i++) size += 2 + strlen(strings[i]);
+    return size;
+}
+
+static unsigned char* table_encode(unsigned char* out, const char* const* strings, unsigned count) {
+    put_u32(out, count);
+    out += 4;
+    for (unsigned i = 0; i < count; i++) {
+        size_t len = strlen(strings[i]);
+        put_u16(out, (unsigned)len);
+        memcpy(out + 2, strings[i], len);
+        out += 2 + len;
+    }
+    return out;
+}
+
+unsigned char* logbin_encode_header(const struct LogBinaryTables* tables, size_t* length) {
+    size_t size = LOGBIN_MAGIC_SIZE + 8
+                + table_size(tables->rooms, tables->room_count)
+                + table_size(tables->evidence, tables->evidence_count)
+                + table_size(tables->ghosts, tables->ghost_count)
+                + table_size(tables->reasons, tables->reason_count);
+
+    unsigned char* header = malloc(size);
+    unsigned char* out = header;
+
+    memcpy(out, LOGBIN_MAGIC, LOGBIN_MAGIC_SIZE);
+    put_u32(out + LOGBIN_MAGIC_SIZE, LOGBIN_VERSION);
+    put_u32(out + LOGBIN_MAGIC_SIZE + 4, LOGBIN_RECORD_SIZE);
+    out += LOGBIN_MAGIC_SIZE + 8;
+
+    out = table_encode(out, tables->rooms, tables->room_count);
+    out = table_encode(out, tables->evidence, tables->evidence_count);
+    out = table_encode(out, tables->ghosts, tables->ghost_count);
+    table_encode(out, tables->reasons, tables->reason_count);
+
+    *length = size;
+    return header;
+}
+
+static bool table_read(FILE* file, const char*** strings, unsigned* count) {
+    unsigned char buf[4];
+    if (fread(buf, 1, 4, file) != 4) return false;
+
+    *count = (unsigned)get_u32(buf);
+    *strings = calloc(*count ? *count : 1, sizeof(char*));
+
+    for (unsigned i = 0; i < *count; i++) {
+        if (fread(buf, 1, 2, file) != 2) return false;
+        unsigned len = get_u16(buf);
+        char* text = malloc(len + 1);
+        (*strings)[i] = text;
+        if (fread(text, 1, len, file) != len) return false;
+        text[len] = '\0';
+    }
+    return true;
+}
+
+bool logbin_read_header(FILE* file, struct LogBinaryTables* tables) {
+    memset(tables, 0, sizeof(*tables));
+
+    unsigned char fixed[LOGBIN_MAGIC_SIZE + 8];
+    if (fread(fixed, 1, sizeof(fixed), file) != sizeof(fixed)) return false;
+    if (memcmp(fixed, LOGBIN_MAGIC, LOGBIN_MAGIC_SIZE) != 0) return false;
+    if (get_u32(fixed + LOGBIN_MAGIC_SIZE) != LOGBIN_VERSION) return false;
+    if (get_u32(fixed + LOGBIN_MAGIC_SIZE + 4) != LOGBIN_RECORD_SIZE) return false;
+
+    return table_read(file, &tables->rooms, &tables->room_count)
+        && table_read(file, &tables->evidence, &tables->evidence_count)
+        && table_read(file, &tables->ghosts, &tables->ghost_count)
+        && table_read(file, &tables->reasons, &tables->reason_count);
+}
+
+static void table_free(const char** strings, unsigned count) {
+    if (!strings) return;
+    for (unsigned i = 0; i < count; i++) free((char*)strings[i]); // Allocated by table_read
+    free(strings);
+}
+
+void logbin_free_tables(struct LogBinaryTables* tables) {
+    table_free(tables->rooms, tables->room_count);
+    table_free(tables->evidence, tables->evidence_count);
+    table_free(tables->ghosts, tables->ghost_count);
+    table_free(tables->reasons, tables->reason_count);
+    memset(tables, 0, sizeof(*tables));
+}
@@ -0,0 +1,122 @@
+#ifndef LOGFORMAT_H
+#define LOGFORMAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "logqueue.h"
+
+// Binary log layout (all integers little-endian):
+//   header:  magic[8] "GHLOGBIN", u32 version, u32 record size,
+//            then four string tables (rooms, evidence, ghosts, exit reasons),
+//            each a u32 count followed by count x (u16 length, bytes)
+//   records: LOGBIN_RECORD_SIZE bytes each, see logbin_encode_record();
+//            a hunter INIT record is followed by its name in
+//            LOGBIN_NAME_SIZE NUL-padded bytes
+#define LOGBIN_MAGIC "GHLOGBIN"
+#define LOGBIN_MAGIC_SIZE 8
+#define LOGBIN_VERSION 1
+#define LOGBIN_RECORD_SIZE 40
+#define LOGBIN_NAME_SIZE 64
+
+#define LOGBIN_INDEX_NONE 0xFFFFFFFFu // Room/extra field not used by the action
+#define LOGBIN_DEVICE_NONE 0xFF // No device (ghost records)
+#define LOGBIN_DEVICE_UNKNOWN 0xFE // Mask that is not a single evidence type
+
+// Output formats of the simulation's log files
+enum LogFormat {
+    LOG_FORMAT_CSV = 0, // log_<id>.csv, nine columns (plus optional sequence)
+    LOG_FORMAT_BINARY   // log_<id>.bin, fixed-width records
+};
+
+// Host-order view of one binary record; strings are indices into the header tables
+struct LogBinaryRecord {
+    unsigned long long sequence;
+    long long timestamp;
+    int entity_id;
+    unsigned room; // Room table index or LOGBIN_INDEX_NONE
+    unsigned extra; // Table index chosen by the action, or LOGBIN_INDEX_NONE
+    int boredom;
+    int fear;
+    unsigned char entity_type; // enum LogEntityType
+    unsigned char action; // enum LogAction
+    unsigned char device; // Evidence table index or LOGBIN_DEVICE_*
+};
+
+// String tables stored in the binary header
+struct LogBinaryTables {
+    const char** rooms;
+    unsigned room_count;
+    const char** evidence;
+    unsigned evidence_count;
+    const char** ghosts;
+    unsigned ghost_count;
+    const char** reasons;
+    unsigned reason_count;
+};
+
+/**
+ * @brief Text written in the "type" column.
+ * @param[in] type Entity type.
+ * @return Static string "hunter" or "ghost"; "unknown" when out of range.
+ */
+const char* log_entity_type_to_string(enum LogEntityType type);
+
+/**
+ * @brief Text written in the "action" column.
+ * @param[in] action Action code.
+ * @return Static string such as "MOVE"; "" when out of range.
+ */
+const char* log_action_to_string(enum LogAction action);
+
+/**
+ * @brief Format one CSV log line, including the trailing newline.
+ * @param[out] line Destination buffer.
+ * @param[in] size Size of line; the line is cut (but still terminated) if too long.
+ * @param[in] record Source of the numeric columns.
+ * @param[in] room Room column text.
+ * @param[in] device Device column text.
+ * @param[in] extra Extra column text.
+ * @param[in] with_sequence true to append the sequence number as a last column.
+ * @return Length of the line in bytes, or 0 on formatting failure.
+ */
+size_t log_format_csv(char* line, size_t size, const struct LogRecord* record,
+                      const char* room, const char* device, const char* extra, bool with_sequence);
+
+/**
+ * @brief Serialize a record into LOGBIN_RECORD_SIZE little-endian bytes.
+ * @param[in] record Record to encode.
+ * @param[out] out Destination of LOGBIN_RECORD_SIZE bytes.
+ */
+void logbin_encode_record(const struct LogBinaryRecord* record, unsigned char* out);
+
+/**
+ * @brief Parse LOGBIN_RECORD_SIZE little-endian bytes into a record.
+ * @param[in] in Encoded record.
+ * @param[out] record Decoded record.
+ */
+void logbin_decode_record(const unsigned char* in, struct LogBinaryRecord* record);
+
+/**
+ * @brief Build a binary log file header.
+ * @param[in] tables String tables to embed.
+ * @param[out] length Size of the returned header.
+ * @return Heap buffer the caller frees.
+ */
+unsigned char* logbin_encode_header(const struct LogBinaryTables* tables, size_t* length);
+
+/**
+ * @brief Read and validate a binary log header.
+ * @param[in] file Stream positioned at the start of a .bin log.
+ * @param[out] tables Filled with heap strings; release with logbin_free_tables().
+ * @return true if the header is valid.
+ */
+bool logbin_read_header(FILE* file, struct LogBinaryTables* tables);
+
+/**
+ * @brief Free tables returned by logbin_read_header().
+ * @param[in,out] tables Tables to release.
+ */
+void logbin_free_tables(struct LogBinaryTables* tables);
+
+#endif // LOGFORMAT_H
@@ -0,0 +1,231 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "logqueue.h"
+#include "logsink.h"
+
+// Set in a segment's tail once a larger segment has replaced it
+#define SEGMENT_CLOSED ((size_t)1 << (sizeof(size_t) * 8 - 1))
+
+// One ring cell; turn tells producers and the consumer whose move it is
+struct LogSlot {
+    _Atomic size_t turn;
+    struct LogRecord record;
+};
+
+// Bounded MPSC ring (Vyukov style); segments only chain under the grow policy
+struct LogSegment {
+    size_t mask; // Capacity - 1
+    _Alignas(64) _Atomic size_t tail; // Next position producers claim
+    _Alignas(64) size_t head; // Next position the writer reads (writer only)
+    _Atomic(struct LogSegment*) next; // Larger segment that replaced this one
+    struct LogSegment* retired; // Drained segments kept until stop
+    struct LogSlot slots[];
+};
+
+enum PushResult {
+    PUSH_OK,
+    PUSH_FULL,
+    PUSH_CLOSED
+};
+
+static _Atomic(struct LogSegment*) tail_segment = NULL; // Where producers push
+static struct LogSegment* head_segment = NULL; // Where the writer pops
+static struct LogSegment* retired_segments = NULL;
+static enum LogBackpressure queue_policy = LOG_BACKPRESSURE_BLOCK;
+static void (*queue_consume)(const struct LogRecord*) = NULL;
+static _Atomic bool queue_running = false;
+static _Atomic bool queue_stopping = false;
+static _Atomic unsigned long long queue_dropped = 0;
+static pthread_mutex_t grow_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t writer_thread;
+
+// ---- Ring segments ----
+static struct LogSegment* segment_create(size_t capacity) {
+    struct LogSegment* seg = aligned_alloc(64, (sizeof(struct LogSegment) + capacity * sizeof(struct LogSlot) + 63) & ~(size_t)63);
+    seg->mask = capacity - 1;
+    atomic_init(&seg->tail, 0);
+    seg->head = 0;
+    atomic_init(&seg->next, NULL);
+    seg->retired = NULL;
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&seg->slots[i].turn, i);
+    }
+    return seg;
+}
+
+static enum PushResult segment_push(struct LogSegment* seg, const struct LogRecord* record) {
+    size_t pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+
+    for (;;) {
+        if (pos & SEGMENT_CLOSED) return PUSH_CLOSED;
+
+        struct LogSlot* slot = &seg->slots[pos & seg->mask];
+        size_t turn = atomic_load_explicit(&slot->turn, memory_order_acquire);
+        intptr_t diff = (intptr_t)turn - (intptr_t)pos;
+
+        if (diff == 0) {
+            // Slot is free for this lap, try to claim it
+            if (atomic_compare_exchange_weak_explicit(&seg->tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                slot->record = *record;
+                atomic_store_explicit(&slot->turn, pos + 1, memory_order_release);
+                return PUSH_OK;
+            }
+        } else if (diff < 0) {
+            return PUSH_FULL; // Writer has not consumed the previous lap yet
+        } else {
+            pos = atomic_load_explicit(&seg->tail, memory_order_relaxed);
+        }
+    }
+}
+
+static bool segment_pop(struct LogSegment* seg, struct LogRecord* out) {
+    struct LogSlot* slot = &seg->slots[seg->head & seg->mask];
+    size_t turn = atomic_load_explicit(&slot->turn, memory_order_acquire);
+
+    if (turn != seg->head + 1) return false; // Empty, or a producer is still copying
+
+    *out = slot->record;
+    atomic_store_explicit(&slot->turn, seg->head + seg->mask + 1, memory_order_release);
+    seg->head++;
+    return true;
+}
+
+// Replace a full segment with one twice its size (grow policy)
+static void segment_grow(struct LogSegment* full) {
+    pthread_mutex_lock(&grow_lock);
+    if (atomic_load(&tail_segment) == full) {
+        struct LogSegment* bigger = segment_create((full->mask + 1) * 2);
+        atomic_store(&full->next, bigger);
+        atomic_store(&tail_segment, bigger);
+        // Producers that still hold the old pointer now fail and move on
+        atomic_fetch_or(&full->tail, SEGMENT_CLOSED);
+    }
+    pthread_mutex_unlock(&grow_lock);
+}
+
+// ---- Writer thread ----
+static bool queue_pop(struct LogRecord* out) {
+    for (;;) {
+        if (segment_pop(head_segment, out)) return true;
+
+        size_t tail = atomic_load(&head_segment->tail);
+        if (!(tail & SEGMENT_CLOSED) || head_segment->head != (tail & ~SEGMENT_CLOSED)) {
+            return false; // Nothing published yet
+        }
+
+        // Old segment fully drained; producers may still read it, so retire it
+        struct LogSegment* drained = head_segment;
+        head_segment = atomic_load(&drained->next);
+        drained->retired = retired_segments;
+        retired_segments = drained;
+    }
+}
+
+static void* writer_main(void* arg) {
+    (void)arg;
+    struct LogRecord record;
+    int idle_rounds = 0;
+
+    for (;;) {
+        bool stopping = atomic_load(&queue_stopping);
+        int drained = 0;
+
+        while (queue_pop(&record)) {
+            queue_consume(&record);
+            drained++;
+        }
+
+        if (drained > 0) {
+            idle_rounds = 0;
+            continue;
+        }
+        if (stopping) break; // Stop was requested before this final empty pass
+
+        // Back off gradually so an idle writer does not burn a core
+        if (++idle_rounds < 64) {
+            sched_yield();
+        } else {
+            struct timespec pause = {0, 200 * 1000}; // 200 us
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    logsink_flush_thread();
+    return NULL;
+}
+
+// ---- Public interface ----
+bool logqueue_start(size_t capacity, enum LogBackpressure policy, void (*consume)(const struct LogRecord*)) {
+    if (atomic_load(&queue_running)) return true;
+
+    size_t rounded = 2;
+    while (rounded < capacity && rounded < LOGQUEUE_MAX_CAPACITY) rounded <<= 1;
+
+    struct LogSegment* seg = segment_create(rounded);
+    head_segment = seg;
+    atomic_store(&tail_segment, seg);
+    queue_policy = policy;
+    queue_consume = consume;
+    atomic_store(&queue_stopping, false);
+    atomic_store(&queue_dropped, 0);
+
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        free(seg);
+        head_segment = NULL;
+        atomic_store(&tail_segment, NULL);
+        return false;
+    }
+
+    atomic_store(&queue_running, true);
+    return true;
+}
+
+bool logqueue_push(const struct LogRecord* record) {
+    if (!atomic_load_explicit(&queue_running, memory_order_acquire)) return false;
+
+    for (;;) {
+        struct LogSegment* seg = atomic_load_explicit(&tail_segment, memory_order_acquire);
+
+        switch (segment_push(seg, record)) {
+            case PUSH_OK:
+                return true;
+            case PUSH_CLOSED:
+                break; // tail_segment already points at the replacement
+            case PUSH_FULL:
+                if (queue_policy == LOG_BACKPRESSURE_DROP) {
+                    atomic_fetch_add_explicit(&queue_dropped, 1, memory_order_relaxed);
+                    return true;
+                }
+                if (queue_policy == LOG_BACKPRESSURE_GROW) {
+                    segment_grow(seg);
+                } else {
+                    sched_yield(); // Block until the writer frees a slot
+                }
+                break;
+        }
+    }
+}
+
+unsigned long long logqueue_stop(void) {
+    if (!atomic_load(&queue_running)) return 0;
+
+    atomic_store(&queue_stopping, true);
+    pthread_join(writer_thread, NULL);
+    atomic_store(&queue_running, false);
+
+    free(head_segment);
+    while (retired_segments) {
+        struct LogSegment* next = retired_segments->retired;
+        free(retired_segments);
+        retired_segments = next;
+    }
+    head_segment = NULL;
+    atomic_store(&tail_segment, NULL);
+
+    return atomic_load(&queue_dropped);
+}
@@ -0,0 +1,76 @@
+#ifndef LOGQUEUE_H
+#define LOGQUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Default number of records the ring holds before backpressure kicks in
+#define LOGQUEUE_DEFAULT_CAPACITY 65536
+
+// Largest ring logqueue_start() allocates
+#define LOGQUEUE_MAX_CAPACITY ((size_t)1 << 30)
+
+// Kind of entity a record belongs to
+enum LogEntityType {
+    LOG_ENTITY_HUNTER = 0,
+    LOG_ENTITY_GHOST = 1
+};
+
+// Action codes written in the "action" column
+enum LogAction {
+    LOG_ACTION_INIT = 0,
+    LOG_ACTION_MOVE,
+    LOG_ACTION_EVIDENCE,
+    LOG_ACTION_SWAP,
+    LOG_ACTION_EXIT,
+    LOG_ACTION_IDLE,
+    LOG_ACTION_RETURN_START,
+    LOG_ACTION_RETURN_COMPLETE
+};
+
+// What a producer does when the ring is full
+enum LogBackpressure {
+    LOG_BACKPRESSURE_BLOCK = 0, // Wait for the writer to make room (lossless)
+    LOG_BACKPRESSURE_DROP,      // Discard the record and count it
+    LOG_BACKPRESSURE_GROW       // Chain a larger ring behind the full one
+};
+
+// Fixed-size log entry; no pointers so it can be copied between threads freely
+struct LogRecord {
+    unsigned long long sequence; // Global event order
+    long long timestamp; // Milliseconds since the epoch (informational)
+    int entity_id; // Hunter or ghost ID
+    int room; // Room index, -1 when the action has no room
+    int extra; // Action specific: room index, evidence, reason, ghost type or name index
+    int boredom; // Boredom at the time of the event
+    int fear; // Fear at the time of the event
+    unsigned char entity_type; // enum LogEntityType
+    unsigned char action; // enum LogAction
+    unsigned char device; // enum EvidenceType bits, 0 for none
+};
+
+/**
+ * @brief Start the background writer thread and its ring buffer.
+ * @param[in] capacity Ring size in records (rounded up to a power of two, at most LOGQUEUE_MAX_CAPACITY).
+ * @param[in] policy Behaviour of producers when the ring is full.
+ * @param[in] consume Called on the writer thread for every record, in order.
+ * @return true when the writer thread is running.
+ */
+bool logqueue_start(size_t capacity, enum LogBackpressure policy, void (*consume)(const struct LogRecord*));
+
+/**
+ * @brief Hand a record to the writer thread.
+ * @param[in] record Record to copy into the ring.
+ * @return false when the queue is not running and the caller must write it itself.
+ */
+bool logqueue_push(const struct LogRecord* record);
+
+/**
+ * @brief Drain every queued record, stop the writer thread and free the ring.
+ * @return Number of records discarded by the drop policy.
+ *
+ * All producers must have finished (threads joined) before calling this.
+ */
+unsigned long long logqueue_stop(void);
+
+#endif // LOGQUEUE_H
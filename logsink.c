@@ -0,0 +1,642 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include "logsink.h"
+#include "loguring.h"
+
+#define LOGSINK_BUCKETS 256
+#define LOGSINK_THREAD_CACHE 4
+#define LOGSINK_FD_RESERVE 32 // Descriptors left for the rest of the process (stdio, io_uring, input files)
+
+// One open log file plus its pending bytes
+struct LogSink {
+    int entity_id; // Entity that owns the file
+    int fd; // Open descriptor, -1 while closed
+    bool created; // The current segment file exists, so reopening appends to it
+    bool broken; // The file could not be opened; records for it are counted as lost
+    bool reported; // An I/O error on this file was already printed
+    int segment; // Current segment number when rotating
+    size_t segment_bytes; // Bytes accepted into the current segment (written or buffered)
+    char* buffer; // Pending bytes not yet written (write and io_uring backends)
+    size_t length; // Number of pending bytes
+    bool async; // Full buffers are queued on the io_uring instead of written
+    off_t offset; // File offset of the next byte (io_uring writes are positional)
+    bool mapped; // Appends go through the mapping (mmap backend)
+    char* map; // Mapping of the whole segment file, NULL until the first append
+    size_t map_size; // Bytes mapped and preallocated
+    _Atomic size_t map_tail; // Bytes of real data in the file; the rest is preallocated zeros
+    pthread_mutex_t lock; // Guards fd/buffer when several threads share an id
+    struct LogSink* next; // Next sink in the same bucket
+    bool listed; // In the open list below, i.e. holding a descriptor and a buffer
+    struct LogSink* lru_prev; // More recently written open sink
+    struct LogSink* lru_next; // Less recently written open sink
+};
+
+// A finished segment that the delete-oldest policy may remove
+struct RetiredSegment {
+    int entity_id;
+    int segment;
+    size_t bytes;
+};
+
+static struct LogSink* sink_table[LOGSINK_BUCKETS];
+static pthread_mutex_t sink_table_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t sink_init_once = PTHREAD_ONCE_INIT;
+
+// Sinks holding a descriptor, most recently written first; the coldest are closed to stay under the limit
+static pthread_mutex_t sink_lru_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct LogSink* sink_lru_head = NULL;
+static struct LogSink* sink_lru_tail = NULL;
+static int sink_open_count = 0;
+static int sink_open_limit = INT_MAX; // Set from RLIMIT_NOFILE on first use
+
+// Bytes lost because a file could not be opened or written
+static _Atomic unsigned long long sink_failed = 0;
+
+// File naming and per-file header chosen by logsink_configure()
+static char sink_extension[16] = "csv";
+static unsigned char* sink_header = NULL;
+static size_t sink_header_len = 0;
+static enum LogSinkBackend sink_backend = LOGSINK_BACKEND_WRITE;
+
+// Rotation and disk budget chosen by logsink_set_limits()
+static size_t sink_segment_size = 0;
+static unsigned long long sink_budget = 0;
+static enum LogBudgetPolicy sink_policy = LOG_BUDGET_STOP;
+
+// Disk usage across every sink, oldest finished segments first
+static pthread_mutex_t budget_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long long budget_used = 0;
+static unsigned long long budget_dropped = 0;
+static bool budget_exhausted = false; // Stop policy: nothing more is written once set
+static struct RetiredSegment* retired = NULL;
+static size_t retired_head = 0;
+static size_t retired_count = 0;
+static size_t retired_capacity = 0;
+
+// Sinks recently used by this thread, so lookups skip the table lock
+static _Thread_local struct LogSink* thread_sinks[LOGSINK_THREAD_CACHE];
+static _Thread_local int thread_sink_count = 0;
+
+// log_<id>.<ext>, or log_<id>.<segment>.<ext> when rotating
+static void sink_path(char* path, size_t size, int entity_id, int segment) {
+    if (sink_segment_size > 0) {
+        snprintf(path, size, "log_%d.%d.%s", entity_id, segment, sink_extension);
+    } else {
+        snprintf(path, size, "log_%d.%s", entity_id, sink_extension);
+    }
+}
+
+// Count lost bytes and print the first error of each sink; later ones would only repeat it
+static void sink_fail_locked(struct LogSink* sink, const char* action, int error, size_t lost) {
+    atomic_fetch_add_explicit(&sink_failed, lost, memory_order_relaxed);
+    if (!sink->reported) {
+        char path[64];
+        sink_path(path, sizeof(path), sink->entity_id, sink->segment);
+        fprintf(stderr, "Cannot %s log file %s: %s\n", action, path, strerror(error));
+        sink->reported = true;
+    }
+}
+
+// ---- Raw I/O ----
+static void sink_write_fully(struct LogSink* sink, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(sink->fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            sink_fail_locked(sink, "write", errno, len);
+            return;
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+}
+
+// Write bytes at the end of the file right away
+static void sink_write_now(struct LogSink* sink, const char* data, size_t len) {
+    if (sink->async) {
+        // Queued writes may still be in flight, so place these bytes explicitly
+        while (len > 0) {
+            ssize_t written = pwrite(sink->fd, data, len, sink->offset);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                sink_fail_locked(sink, "write", errno, len);
+                return;
+            }
+            data += written;
+            len -= (size_t)written;
+            sink->offset += written;
+        }
+    } else {
+        sink_write_fully(sink, data, len);
+    }
+}
+
+static void sink_flush_locked(struct LogSink* sink) {
+    if (sink->length > 0 && sink->fd >= 0) {
+        if (sink->async) {
+            // The ring owns the full buffer until its write completes; keep filling a fresh one
+            loguring_write(sink->fd, sink->buffer, sink->length, sink->offset);
+            sink->offset += (off_t)sink->length;
+            sink->buffer = loguring_buffer();
+        } else {
+            sink_write_fully(sink, sink->buffer, sink->length);
+        }
+    }
+    sink->length = 0;
+}
+
+// ---- Memory-mapped files ----
+// Drop the mapping and cut the preallocated tail off the file
+static void sink_unmap_locked(struct LogSink* sink) {
+    if (sink->map) {
+        munmap(sink->map, sink->map_size);
+        sink->map = NULL;
+        sink->map_size = 0;
+        if (ftruncate(sink->fd, (off_t)atomic_load_explicit(&sink->map_tail, memory_order_relaxed)) != 0) {
+            // Best effort: the file keeps its zero padding
+        }
+    }
+}
+
+// Make room for len more bytes, growing the file and mapping in whole chunks
+static bool sink_map_reserve_locked(struct LogSink* sink, size_t len) {
+    size_t tail = atomic_load_explicit(&sink->map_tail, memory_order_relaxed);
+    if (sink->map && tail + len <= sink->map_size) {
+        return true;
+    }
+
+    size_t size = sink->map_size;
+    while (size < tail + len) {
+        size += LOGSINK_MAP_CHUNK;
+    }
+
+    if (sink->map) {
+        munmap(sink->map, sink->map_size);
+        sink->map = NULL;
+    }
+    sink->map_size = size;
+
+    // posix_fallocate reserves real blocks, so a full disk fails here instead of as SIGBUS later
+    void* map = MAP_FAILED;
+    if (posix_fallocate(sink->fd, 0, (off_t)size) == 0) {
+        map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, sink->fd, 0);
+    }
+    if (map == MAP_FAILED) {
+        // Trim the padding and continue on plain write()s (fd is O_APPEND)
+        sink->map_size = 0;
+        if (ftruncate(sink->fd, (off_t)tail) != 0) {
+            // Nothing else to try
+        }
+        sink->mapped = false;
+        return false;
+    }
+
+    sink->map = map;
+    return true;
+}
+
+// ---- Disk budget ----
+static void retired_push(int entity_id, int segment, size_t bytes) {
+    if (retired_count == retired_capacity) {
+        // Grow the FIFO and unwrap it so the oldest entry is at index 0
+        size_t capacity = retired_capacity == 0 ? 64 : retired_capacity * 2;
+        struct RetiredSegment* grown = malloc(capacity * sizeof(struct RetiredSegment));
+        for (size_t i = 0; i < retired_count; i++) {
+            grown[i] = retired[(retired_head + i) % retired_capacity];
+        }
+        free(retired);
+        retired = grown;
+        retired_head = 0;
+        retired_capacity = capacity;
+    }
+    retired[(retired_head + retired_count) % retired_capacity] = (struct RetiredSegment){ entity_id, segment, bytes };
+    retired_count++;
+}
+
+// Account for len more bytes on disk; false means the bytes must not be written
+static bool budget_reserve(size_t len) {
+    pthread_mutex_lock(&budget_lock);
+
+    if (sink_budget > 0 && sink_policy == LOG_BUDGET_DELETE_OLDEST) {
+        // Free space by deleting the oldest finished segments of any entity
+        while (budget_used + len > sink_budget && retired_count > 0) {
+            struct RetiredSegment oldest = retired[retired_head];
+            retired_head = (retired_head + 1) % retired_capacity;
+            retired_count--;
+
+            char path[64];
+            sink_path(path, sizeof(path), oldest.entity_id, oldest.segment);
+            unlink(path);
+            budget_used -= oldest.bytes;
+        }
+    }
+
+    bool fits = !budget_exhausted && (sink_budget == 0 || budget_used + len <= sink_budget);
+    if (fits) {
+        budget_used += len;
+    } else {
+        budget_dropped += len;
+        budget_exhausted = (sink_policy == LOG_BUDGET_STOP);
+    }
+
+    pthread_mutex_unlock(&budget_lock);
+    return fits;
+}
+
+// Account for bytes that are written regardless of the budget (segment headers)
+static void budget_charge(size_t len) {
+    pthread_mutex_lock(&budget_lock);
+    budget_used += len;
+    pthread_mutex_unlock(&budget_lock);
+}
+
+static void budget_retire(int entity_id, int segment, size_t bytes) {
+    pthread_mutex_lock(&budget_lock);
+    retired_push(entity_id, segment, bytes);
+    pthread_mutex_unlock(&budget_lock);
+}
+
+// ---- Appending ----
+static void sink_append_locked(struct LogSink* sink, const char* data, size_t len) {
+    if (sink->mapped && sink_map_reserve_locked(sink, len)) {
+        // No syscall: copy into the shared mapping and publish the new end
+        size_t tail = atomic_load_explicit(&sink->map_tail, memory_order_relaxed);
+        memcpy(sink->map + tail, data, len);
+        atomic_store_explicit(&sink->map_tail, tail + len, memory_order_release);
+        return;
+    }
+
+    if (sink->length + len > LOGSINK_BUFFER_SIZE) {
+        sink_flush_locked(sink);
+    }
+    if (len > LOGSINK_BUFFER_SIZE) {
+        // Larger than the whole buffer, hand it straight to the kernel
+        sink_write_now(sink, data, len);
+    } else {
+        memcpy(sink->buffer + sink->length, data, len);
+        sink->length += len;
+    }
+}
+
+static void sink_close_locked(struct LogSink* sink) {
+    sink_flush_locked(sink);
+    if (sink->async) {
+        loguring_drain_fd(sink->fd); // The descriptor must outlive its queued writes
+    }
+    sink_unmap_locked(sink);
+    if (sink->fd >= 0) close(sink->fd);
+    sink->fd = -1;
+}
+
+// ---- Segments ----
+// Open the current segment: created (and given its header) the first time, appended to after that
+static int sink_open_segment(struct LogSink* sink) {
+    char path[64];
+    sink_path(path, sizeof(path), sink->entity_id, sink->segment);
+
+    // io_uring writes carry their own offsets; O_APPEND would make them ignore it
+    bool async = (sink_backend == LOGSINK_BACKEND_URING && loguring_running());
+
+    // Segments and headed (binary) files describe a single run; plain CSV keeps appending
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC;
+    if (!async) flags |= O_APPEND;
+    if (!sink->created && (sink_header || sink_segment_size > 0)) flags |= O_TRUNC;
+    sink->fd = open(path, flags, 0644);
+    if (sink->fd < 0) {
+        return errno;
+    }
+    // A reopened cold sink appends with write(2): mapping a fresh chunk for a few records costs more than it saves
+    sink->mapped = (sink_backend == LOGSINK_BACKEND_MMAP && !sink->created);
+    sink->async = async;
+
+    if (sink->async) {
+        sink->offset = lseek(sink->fd, 0, SEEK_END);
+    }
+
+    if (sink->mapped) {
+        // Appending to an existing CSV file starts mapping after its old contents
+        off_t existing = lseek(sink->fd, 0, SEEK_END);
+        atomic_store_explicit(&sink->map_tail, existing > 0 ? (size_t)existing : 0, memory_order_relaxed);
+    }
+
+    if (!sink->created) {
+        sink->created = true;
+        sink->segment_bytes = 0;
+        if (sink_header) {
+            // Every segment is self-describing, so it always gets its header
+            budget_charge(sink_header_len);
+            sink_append_locked(sink, (const char*)sink_header, sink_header_len);
+            sink->segment_bytes = sink_header_len;
+        }
+    }
+    return 0;
+}
+
+// ---- Open descriptors ----
+// The open list is guarded by sink_lru_lock
+static void sink_lru_unlink(struct LogSink* sink) {
+    if (sink->lru_prev) sink->lru_prev->lru_next = sink->lru_next;
+    else sink_lru_head = sink->lru_next;
+    if (sink->lru_next) sink->lru_next->lru_prev = sink->lru_prev;
+    else sink_lru_tail = sink->lru_prev;
+    sink->lru_prev = sink->lru_next = NULL;
+    sink->listed = false;
+    sink_open_count--;
+}
+
+static void sink_lru_push(struct LogSink* sink) {
+    sink->lru_prev = NULL;
+    sink->lru_next = sink_lru_head;
+    if (sink_lru_head) sink_lru_head->lru_prev = sink;
+    else sink_lru_tail = sink;
+    sink_lru_head = sink;
+    sink->listed = true;
+    sink_open_count++;
+}
+
+// Flush and close the least recently written sink nobody is using; false if every open sink is busy
+static bool sink_evict_lru(void) {
+    for (struct LogSink* victim = sink_lru_tail; victim; victim = victim->lru_prev) {
+        // Never wait here: the caller holds another sink's lock
+        if (pthread_mutex_trylock(&victim->lock) != 0) continue;
+
+        sink_lru_unlink(victim);
+        sink_close_locked(victim);
+        free(victim->buffer); // Cold sinks give their buffer back too
+        victim->buffer = NULL;
+
+        pthread_mutex_unlock(&victim->lock);
+        return true;
+    }
+    return false;
+}
+
+// Give a closed sink its descriptor back, closing cold sinks to stay under the limit
+static void sink_reopen_locked(struct LogSink* sink) {
+    pthread_mutex_lock(&sink_lru_lock);
+    while (sink_open_count >= sink_open_limit && sink_evict_lru()) {
+    }
+    pthread_mutex_unlock(&sink_lru_lock);
+
+    if (!sink->buffer) {
+        sink->buffer = malloc(LOGSINK_BUFFER_SIZE);
+    }
+
+    int error = sink_open_segment(sink);
+    while (error == EMFILE || error == ENFILE) {
+        // Other descriptors used up the table after all: close one more sink and retry
+        pthread_mutex_lock(&sink_lru_lock);
+        bool evicted = sink_evict_lru();
+        pthread_mutex_unlock(&sink_lru_lock);
+        if (!evicted) break;
+        error = sink_open_segment(sink);
+    }
+    if (error != 0) {
+        sink->broken = true;
+        sink_fail_locked(sink, "open", error, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&sink_lru_lock);
+    sink_lru_push(sink);
+    pthread_mutex_unlock(&sink_lru_lock);
+}
+
+// Move an open sink to the front of the list
+static void sink_touch_locked(struct LogSink* sink) {
+    pthread_mutex_lock(&sink_lru_lock);
+    if (sink_lru_head != sink) {
+        sink_lru_unlink(sink);
+        sink_lru_push(sink);
+    }
+    pthread_mutex_unlock(&sink_lru_lock);
+}
+
+// Finish the current segment; the next write opens the following one
+static void sink_rotate_locked(struct LogSink* sink) {
+    if (sink->listed) {
+        pthread_mutex_lock(&sink_lru_lock);
+        sink_lru_unlink(sink);
+        pthread_mutex_unlock(&sink_lru_lock);
+    }
+    sink_close_locked(sink);
+
+    budget_retire(sink->entity_id, sink->segment, sink->segment_bytes);
+
+    sink->segment++;
+    sink->created = false;
+}
+
+// Flush (but keep open) every sink, used when the process exits early
+static void sink_flush_all(void) {
+    pthread_mutex_lock(&sink_table_lock);
+    for (int bucket = 0; bucket < LOGSINK_BUCKETS; bucket++) {
+        for (struct LogSink* sink = sink_table[bucket]; sink; sink = sink->next) {
+            pthread_mutex_lock(&sink->lock);
+            sink_flush_locked(sink);
+            // Leave a file without padding; later appends fall back to write()
+            sink_unmap_locked(sink);
+            sink->mapped = false;
+            pthread_mutex_unlock(&sink->lock);
+        }
+    }
+    pthread_mutex_unlock(&sink_table_lock);
+
+    loguring_drain();
+}
+
+// Flush at exit, and keep enough descriptors free for everything else the process opens
+static void sink_init(void) {
+    atexit(sink_flush_all);
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return;
+    }
+    if (limit.rlim_cur < limit.rlim_max) {
+        // Allowed without privileges, and every descriptor is one sink fewer to reopen
+        limit.rlim_cur = limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &limit) != 0) {
+            getrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < (rlim_t)INT_MAX) {
+        long usable = (long)limit.rlim_cur - LOGSINK_FD_RESERVE;
+        sink_open_limit = usable > 1 ? (int)usable : 1;
+    }
+}
+
+// ---- Sink lookup ----
+// New sinks start closed; their file is opened by the first write
+static struct LogSink* sink_create(int entity_id) {
+    pthread_once(&sink_init_once, sink_init);
+
+    struct LogSink* sink = calloc(1, sizeof(struct LogSink));
+    sink->entity_id = entity_id;
+    sink->fd = -1;
+    pthread_mutex_init(&sink->lock, NULL);
+
+    return sink;
+}
+
+static struct LogSink* sink_lookup(int entity_id) {
+    // Fast path: agent threads almost always log for the same entity
+    for (int i = 0; i < thread_sink_count; i++) {
+        if (thread_sinks[i]->entity_id == entity_id) {
+            return thread_sinks[i];
+        }
+    }
+
+    unsigned bucket = (unsigned)entity_id % LOGSINK_BUCKETS;
+
+    pthread_mutex_lock(&sink_table_lock);
+    struct LogSink* sink = sink_table[bucket];
+    while (sink && sink->entity_id != entity_id) {
+        sink = sink->next;
+    }
+    if (!sink) {
+        sink = sink_create(entity_id);
+        sink->next = sink_table[bucket];
+        sink_table[bucket] = sink;
+    }
+    pthread_mutex_unlock(&sink_table_lock);
+
+    // Remember the sink; evict the oldest entry once the cache is full
+    if (thread_sink_count == LOGSINK_THREAD_CACHE) {
+        memmove(thread_sinks, thread_sinks + 1, sizeof(thread_sinks[0]) * (LOGSINK_THREAD_CACHE - 1));
+        thread_sink_count--;
+    }
+    thread_sinks[thread_sink_count++] = sink;
+
+    return sink;
+}
+
+// ---- Public interface ----
+void logsink_configure(const char* extension, const void* header, size_t header_len) {
+    snprintf(sink_extension, sizeof(sink_extension), "%s", extension);
+
+    free(sink_header);
+    sink_header = NULL;
+    sink_header_len = 0;
+    if (header && header_len > 0) {
+        sink_header = malloc(header_len);
+        memcpy(sink_header, header, header_len);
+        sink_header_len = header_len;
+    }
+}
+
+bool logsink_set_backend(enum LogSinkBackend backend) {
+    if (backend == LOGSINK_BACKEND_URING && !loguring_start(LOGSINK_BUFFER_SIZE)) {
+        sink_backend = LOGSINK_BACKEND_WRITE;
+        return false;
+    }
+    sink_backend = backend;
+    return true;
+}
+
+void logsink_set_limits(size_t segment_size, unsigned long long budget, enum LogBudgetPolicy policy) {
+    sink_segment_size = segment_size;
+    sink_budget = budget;
+    sink_policy = policy;
+}
+
+void logsink_write(int entity_id, const char* data, size_t len) {
+    struct LogSink* sink = sink_lookup(entity_id);
+
+    pthread_mutex_lock(&sink->lock);
+
+    // Start a new segment rather than grow this one past its size
+    if (sink_segment_size > 0 && sink->segment_bytes > sink_header_len &&
+        sink->segment_bytes + len > sink_segment_size) {
+        sink_rotate_locked(sink);
+    }
+
+    if (sink->fd >= 0) {
+        sink_touch_locked(sink);
+    } else if (!sink->broken) {
+        sink_reopen_locked(sink);
+    }
+    if (sink->fd < 0) {
+        // The open failure was already reported; count what it costs
+        atomic_fetch_add_explicit(&sink_failed, len, memory_order_relaxed);
+        pthread_mutex_unlock(&sink->lock);
+        return;
+    }
+
+    if (!budget_reserve(len)) {
+        pthread_mutex_unlock(&sink->lock); // Over budget: keep simulating, stop logging
+        return;
+    }
+
+    sink_append_locked(sink, data, len);
+    sink->segment_bytes += len;
+
+    pthread_mutex_unlock(&sink->lock);
+}
+
+void logsink_flush_thread(void) {
+    for (int i = 0; i < thread_sink_count; i++) {
+        pthread_mutex_lock(&thread_sinks[i]->lock);
+        sink_flush_locked(thread_sinks[i]);
+        pthread_mutex_unlock(&thread_sinks[i]->lock);
+    }
+    loguring_submit(); // Queued buffers go to the kernel now, without waiting for them
+}
+
+struct LogSinkLoss logsink_close_all(void) {
+    pthread_mutex_lock(&sink_table_lock);
+
+    // Queue every pending buffer first so the io_uring backend waits once, not once per file
+    for (int bucket = 0; bucket < LOGSINK_BUCKETS; bucket++) {
+        for (struct LogSink* sink = sink_table[bucket]; sink; sink = sink->next) {
+            sink_flush_locked(sink);
+        }
+    }
+    loguring_drain();
+
+    for (int bucket = 0; bucket < LOGSINK_BUCKETS; bucket++) {
+        struct LogSink* sink = sink_table[bucket];
+        while (sink) {
+            struct LogSink* next = sink->next;
+
+            sink_close_locked(sink);
+            pthread_mutex_destroy(&sink->lock);
+            free(sink->buffer);
+            free(sink);
+
+            sink = next;
+        }
+        sink_table[bucket] = NULL;
+    }
+    sink_lru_head = sink_lru_tail = NULL;
+    sink_open_count = 0;
+    pthread_mutex_unlock(&sink_table_lock);
+
+    // Only the closing thread's cache can be cleared; agent threads are gone
+    thread_sink_count = 0;
+
+    struct LogSinkLoss loss;
+    loss.failed = loguring_stop() + atomic_exchange_explicit(&sink_failed, 0, memory_order_relaxed);
+
+    pthread_mutex_lock(&budget_lock);
+    loss.over_budget = budget_dropped;
+    free(retired);
+    retired = NULL;
+    retired_head = retired_count = retired_capacity = 0;
+    budget_used = 0;
+    budget_dropped = 0;
+    budget_exhausted = false;
+    pthread_mutex_unlock(&budget_lock);
+
+    return loss;
+}
@@ -0,0 +1,103 @@
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bytes buffered per entity before the sink is flushed to disk
+#define LOGSINK_BUFFER_SIZE (64 * 1024)
+
+// Bytes the mmap backend preallocates and maps at a time
+#define LOGSINK_MAP_CHUNK (4 * 1024 * 1024)
+
+// How sinks move bytes to their files
+enum LogSinkBackend {
+    LOGSINK_BACKEND_WRITE = 0, // User-space buffer flushed with write(2)
+    LOGSINK_BACKEND_MMAP,      // Preallocated, memory-mapped file appended with memcpy
+    LOGSINK_BACKEND_URING      // Full buffers queued as batched io_uring writes (Linux)
+};
+
+// Log data logsink_close_all() reports as not written
+struct LogSinkLoss {
+    unsigned long long over_budget; // Bytes skipped because of the disk budget
+    unsigned long long failed; // Bytes lost because a file could not be opened or written
+};
+
+// What happens once the total disk budget is used up
+enum LogBudgetPolicy {
+    LOG_BUDGET_STOP = 0,      // Stop writing logs, keep simulating
+    LOG_BUDGET_DELETE_OLDEST  // Delete the oldest finished segments (of any entity) to make room
+};
+
+/**
+ * @brief Choose the file extension and optional header of new log files.
+ * @param[in] extension File extension without the dot, e.g. "csv" or "bin".
+ * @param[in] header Bytes written at the start of every file, or NULL.
+ * @param[in] header_len Size of header.
+ *
+ * Without a header files are appended to, matching the historical CSV logs.
+ * With a header each file is truncated first so it describes a single run.
+ * Must be called before the first write.
+ */
+void logsink_configure(const char* extension, const void* header, size_t header_len);
+
+/**
+ * @brief Select how sinks write their files.
+ * @param[in] backend Backend for every sink opened afterwards; set before the first write.
+ * @return false when io_uring is unavailable and the write backend is used instead.
+ *
+ * The mmap backend grows each file in LOGSINK_MAP_CHUNK steps with
+ * posix_fallocate and appends without any syscall. Other processes can read
+ * the data while the simulation runs; until the sink is closed the file ends
+ * in zero padding. If a file cannot be mapped it falls back to write(2).
+ *
+ * The io_uring backend hands each full buffer to the kernel and continues in
+ * a fresh one, so the logging thread never waits in write(2).
+ */
+bool logsink_set_backend(enum LogSinkBackend backend);
+
+/**
+ * @brief Limit the size of individual log files and of all logs together.
+ * @param[in] segment_size Bytes per file before rotating to log_<id>.<n>.<ext>; 0 keeps one log_<id>.<ext>.
+ * @param[in] budget Total bytes all sinks may occupy on disk; 0 for no limit.
+ * @param[in] policy What to do once the budget is used up.
+ *
+ * Records are never split across segments. Deleting only ever removes
+ * finished segments, so it needs rotation to have anything to delete; once
+ * nothing is left to delete, new data is dropped. Must be called before the first write.
+ */
+void logsink_set_limits(size_t segment_size, unsigned long long budget, enum LogBudgetPolicy policy);
+
+/**
+ * @brief Append raw bytes to the log file of an entity (log_<id>.<ext>).
+ * @param[in] entity_id Entity whose log receives the data.
+ * @param[in] data Bytes to append.
+ * @param[in] len Number of bytes in data.
+ *
+ * The file is opened on first use and kept open; data is buffered in user
+ * space (or copied into the mapping) and only written once the buffer fills
+ * or the sink is flushed. Only as many files stay open as RLIMIT_NOFILE
+ * allows (the soft limit is raised to the hard one): past that, the least
+ * recently written sink is flushed and closed, and reopened in append mode
+ * when its entity logs again. A file that cannot be opened or written is
+ * reported on stderr once and its bytes are counted as lost.
+ */
+void logsink_write(int entity_id, const char* data, size_t len);
+
+/**
+ * @brief Flush every sink the calling thread has written to.
+ *
+ * Agent threads call this right before returning so their tail of the log
+ * reaches disk even while other threads are still running.
+ */
+void logsink_flush_thread(void);
+
+/**
+ * @brief Flush and close every open sink, trimming mapped files to their data.
+ * @return Bytes that were not written, because of the disk budget or because of I/O errors.
+ *
+ * Must only be called once no other thread is logging (after the joins).
+ */
+struct LogSinkLoss logsink_close_all(void);
+
+#endif // LOGSINK_H
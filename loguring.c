@@ -0,0 +1,339 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "loguring.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+// One write owned by the ring until its completion is reaped
+struct UringRequest {
+    char* buffer;
+    size_t len;
+    int fd;
+    off_t offset;
+};
+
+// Raw io_uring instance (no liburing): the three shared mappings and their fields
+struct Uring {
+    int fd;
+    unsigned entries;
+
+    void* sq_map;
+    size_t sq_map_size;
+    _Atomic unsigned* sq_head;
+    _Atomic unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+
+    void* cq_map;
+    size_t cq_map_size;
+    _Atomic unsigned* cq_head;
+    _Atomic unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+};
+
+static struct Uring ring = { .fd = -1 };
+static pthread_mutex_t ring_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t ring_buffer_size = 0;
+
+// Request slots; free_slots holds the indices not in flight
+static struct UringRequest requests[LOGURING_ENTRIES];
+static int free_slots[LOGURING_ENTRIES];
+static int free_count = 0;
+static unsigned queued = 0; // Prepared but not yet submitted
+static unsigned in_flight = 0; // Submitted or queued, completion not reaped
+
+// Buffers of completed writes, reused before allocating new ones
+static char* spare_buffers[LOGURING_ENTRIES];
+static int spare_count = 0;
+
+static unsigned long long failed_bytes = 0; // Bytes even the pwrite(2) fallback could not write
+
+// ---- Ring setup ----
+static bool ring_map(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) return false;
+
+    ring.fd = fd;
+    ring.entries = params.sq_entries;
+    ring.sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // Newer kernels share one mapping between both rings
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && ring.cq_map_size > ring.sq_map_size) ring.sq_map_size = ring.cq_map_size;
+
+    ring.sq_map = mmap(NULL, ring.sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring.sq_map == MAP_FAILED) {
+        close(fd);
+        ring.fd = -1;
+        return false;
+    }
+
+    ring.cq_map = single ? ring.sq_map
+                         : mmap(NULL, ring.cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    ring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring.sqes = mmap(NULL, ring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring.cq_map == MAP_FAILED || ring.sqes == MAP_FAILED) {
+        if (ring.sqes != MAP_FAILED) munmap(ring.sqes, ring.sqes_size);
+        if (!single && ring.cq_map != MAP_FAILED) munmap(ring.cq_map, ring.cq_map_size);
+        munmap(ring.sq_map, ring.sq_map_size);
+        close(fd);
+        ring.fd = -1;
+        return false;
+    }
+
+    char* sq = ring.sq_map;
+    ring.sq_head = (_Atomic unsigned*)(sq + params.sq_off.head);
+    ring.sq_tail = (_Atomic unsigned*)(sq + params.sq_off.tail);
+    ring.sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    ring.sq_array = (unsigned*)(sq + params.sq_off.array);
+
+    char* cq = ring.cq_map;
+    ring.cq_head = (_Atomic unsigned*)(cq + params.cq_off.head);
+    ring.cq_tail = (_Atomic unsigned*)(cq + params.cq_off.tail);
+    ring.cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return true;
+}
+
+static void ring_unmap(void) {
+    munmap(ring.sqes, ring.sqes_size);
+    if (ring.cq_map != ring.sq_map) munmap(ring.cq_map, ring.cq_map_size);
+    munmap(ring.sq_map, ring.sq_map_size);
+    close(ring.fd);
+    ring.fd = -1;
+}
+
+// ---- Completions ----
+// Returns the bytes that could not be written
+static size_t pwrite_fully(int fd, const char* data, size_t len, off_t offset) {
+    while (len > 0) {
+        ssize_t written = pwrite(fd, data, len, offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return len;
+        }
+        data += written;
+        len -= (size_t)written;
+        offset += written;
+    }
+    return 0;
+}
+
+static void recycle_buffer(char* buffer) {
+    if (spare_count < LOGURING_ENTRIES) {
+        spare_buffers[spare_count++] = buffer;
+    } else {
+        free(buffer);
+    }
+}
+
+static void complete(int slot, int result) {
+    struct UringRequest* request = &requests[slot];
+
+    // Finish a short write, or redo a failed one (e.g. IORING_OP_WRITE unsupported) synchronously
+    size_t done = result > 0 ? (size_t)result : 0;
+    if (done < request->len) {
+        failed_bytes += pwrite_fully(request->fd, request->buffer + done, request->len - done, request->offset + (off_t)done);
+    }
+
+    recycle_buffer(request->buffer);
+    request->buffer = NULL;
+    free_slots[free_count++] = slot;
+    in_flight--;
+}
+
+static void reap_locked(void) {
+    unsigned head = atomic_load_explicit(ring.cq_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(ring.cq_tail, memory_order_acquire);
+
+    while (head != tail) {
+        struct io_uring_cqe* cqe = &ring.cqes[head & ring.cq_mask];
+        complete((int)cqe->user_data, cqe->res);
+        head++;
+    }
+    atomic_store_explicit(ring.cq_head, head, memory_order_release);
+}
+
+// Submit queued entries and optionally wait for at least wait_for completions
+static void enter_locked(unsigned wait_for) {
+    unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    while (queued > 0 || wait_for > 0) {
+        int submitted = (int)syscall(__NR_io_uring_enter, ring.fd, queued, wait_for, flags, NULL, 0);
+        if (submitted < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                reap_locked();
+                continue;
+            }
+            break;
+        }
+        queued -= (unsigned)submitted;
+        break;
+    }
+    reap_locked();
+}
+
+// ---- Public interface ----
+bool loguring_start(size_t buffer_size) {
+    pthread_mutex_lock(&ring_lock);
+    bool ok = ring.fd >= 0;
+    if (!ok && ring_map(LOGURING_ENTRIES)) {
+        ring_buffer_size = buffer_size;
+        free_count = 0;
+        for (int i = 0; i < LOGURING_ENTRIES; i++) free_slots[free_count++] = i;
+        ok = true;
+    }
+    pthread_mutex_unlock(&ring_lock);
+    return ok;
+}
+
+bool loguring_running(void) {
+    pthread_mutex_lock(&ring_lock);
+    bool running = ring.fd >= 0;
+    pthread_mutex_unlock(&ring_lock);
+    return running;
+}
+
+char* loguring_buffer(void) {
+    pthread_mutex_lock(&ring_lock);
+    char* buffer = spare_count > 0 ? spare_buffers[--spare_count] : NULL;
+    size_t size = ring_buffer_size;
+    pthread_mutex_unlock(&ring_lock);
+
+    return buffer ? buffer : malloc(size);
+}
+
+void loguring_write(int fd, char* buffer, size_t len, off_t offset) {
+    pthread_mutex_lock(&ring_lock);
+
+    // Every slot in flight: wait for the kernel to finish one
+    while (free_count == 0) {
+        enter_locked(1);
+    }
+
+    int slot = free_slots[--free_count];
+    requests[slot] = (struct UringRequest){ buffer, len, fd, offset };
+    in_flight++;
+
+    unsigned tail = atomic_load_explicit(ring.sq_tail, memory_order_relaxed);
+    unsigned index = tail & ring.sq_mask;
+    struct io_uring_sqe* sqe = &ring.sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long long)(uintptr_t)buffer;
+    sqe->len = (unsigned)len;
+    sqe->off = (unsigned long long)offset;
+    sqe->user_data = (unsigned long long)slot;
+    ring.sq_array[index] = index;
+    atomic_store_explicit(ring.sq_tail, tail + 1, memory_order_release);
+    queued++;
+
+    if (queued >= LOGURING_BATCH) {
+        enter_locked(0);
+    }
+
+    pthread_mutex_unlock(&ring_lock);
+}
+
+void loguring_submit(void) {
+    pthread_mutex_lock(&ring_lock);
+    if (ring.fd >= 0 && queued > 0) {
+        enter_locked(0);
+    }
+    pthread_mutex_unlock(&ring_lock);
+}
+
+void loguring_drain(void) {
+    pthread_mutex_lock(&ring_lock);
+    while (ring.fd >= 0 && in_flight > 0) {
+        enter_locked(1);
+    }
+    pthread_mutex_unlock(&ring_lock);
+}
+
+// A slot is in flight while it owns a buffer; complete() clears it
+static bool fd_in_flight_locked(int fd) {
+    for (int slot = 0; slot < LOGURING_ENTRIES; slot++) {
+        if (requests[slot].buffer && requests[slot].fd == fd) return true;
+    }
+    return false;
+}
+
+void loguring_drain_fd(int fd) {
+    pthread_mutex_lock(&ring_lock);
+    while (ring.fd >= 0 && fd_in_flight_locked(fd)) {
+        enter_locked(1);
+    }
+    pthread_mutex_unlock(&ring_lock);
+}
+
+unsigned long long loguring_stop(void) {
+    loguring_drain();
+
+    pthread_mutex_lock(&ring_lock);
+    if (ring.fd >= 0) {
+        ring_unmap();
+    }
+    while (spare_count > 0) {
+        free(spare_buffers[--spare_count]);
+    }
+    unsigned long long failed = failed_bytes;
+    failed_bytes = 0;
+    pthread_mutex_unlock(&ring_lock);
+    return failed;
+}
+
+#else // No io_uring on this platform: the sinks keep using write(2)
+
+bool loguring_start(size_t buffer_size) {
+    (void)buffer_size;
+    return false;
+}
+
+bool loguring_running(void) {
+    return false;
+}
+
+char* loguring_buffer(void) {
+    return NULL;
+}
+
+void loguring_write(int fd, char* buffer, size_t len, off_t offset) {
+    (void)fd;
+    (void)buffer;
+    (void)len;
+    (void)offset;
+}
+
+void loguring_submit(void) {
+}
+
+void loguring_drain(void) {
+}
+
+void loguring_drain_fd(int fd) {
+    (void)fd;
+}
+
+unsigned long long loguring_stop(void) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef LOGURING_H
+#define LOGURING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+// Submission queue size; also the most writes that can be in flight at once
+#define LOGURING_ENTRIES 64
+
+// Queued writes handed to the kernel with a single io_uring_enter
+#define LOGURING_BATCH 16
+
+/**
+ * @brief Create the io_uring instance used by the log sinks.
+ * @param[in] buffer_size Size of the buffers handed out by loguring_buffer().
+ * @return false when io_uring is not available (non-Linux, old kernel, seccomp).
+ */
+bool loguring_start(size_t buffer_size);
+
+/**
+ * @brief Check whether loguring_start() succeeded and loguring_stop() has not run.
+ * @return true while writes can be queued.
+ */
+bool loguring_running(void);
+
+/**
+ * @brief Get an empty buffer of the size given to loguring_start().
+ * @return A recycled buffer from a completed write, or a new one.
+ */
+char* loguring_buffer(void);
+
+/**
+ * @brief Queue a write of a buffer at an explicit file offset.
+ * @param[in] fd Destination file; must stay open until loguring_drain() returns.
+ * @param[in] buffer Buffer from loguring_buffer(); ownership passes to the ring.
+ * @param[in] len Bytes to write.
+ * @param[in] offset File offset of the first byte.
+ *
+ * Writes are submitted in batches of LOGURING_BATCH. The caller only waits
+ * when every ring entry is already in flight. Short or failed writes are
+ * finished with pwrite(2) when their completion is reaped.
+ */
+void loguring_write(int fd, char* buffer, size_t len, off_t offset);
+
+/**
+ * @brief Hand every queued write to the kernel without waiting for it.
+ */
+void loguring_submit(void);
+
+/**
+ * @brief Submit queued writes and wait until all of them have completed.
+ */
+void loguring_drain(void);
+
+/**
+ * @brief Submit queued writes and wait until those to one file have completed.
+ * @param[in] fd File about to be closed; writes to other files stay in flight.
+ */
+void loguring_drain_fd(int fd);
+
+/**
+ * @brief Drain, then release the ring and its buffers.
+ * @return Bytes lost because a write failed even when redone with pwrite(2).
+ */
+unsigned long long loguring_stop(void);
+
+#endif // LOGURING_H
@@ -1,19 +1,428 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <getopt.h>
 #include "defs.h"
 #include "helpers.h"
+#include "console.h"
+#include "logsink.h"
+#include "batch.h"
+#include "layout.h"
+#include "lanes.h"
 
-int main() {
+// Print command-line help
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --log-seq                 append the global event sequence number as a last CSV column\n"
+            "  --log-format=FORMAT       csv (default) or binary log_<id>.bin files (see ghostlog2csv)\n"
+            "  --log-backend=MODE        write (default), mmap or io_uring: how log files are written\n"
+            "  --log-queue=N             records buffered for the log writer thread (default %d)\n"
+            "  --log-backpressure=MODE   when the log queue is full: block, drop or grow (default block)\n"
+            "  --log-segment-size=SIZE   rotate to log_<id>.<n>.<ext> once a file reaches SIZE bytes (K/M/G suffixes)\n"
+            "  --log-budget=SIZE         total disk space all logs may use (default unlimited)\n"
+            "  --log-budget-policy=MODE  when the budget is used up: stop or delete-oldest (default stop)\n"
+            "  --seed=N                  master seed; the same seed and hunters replay the same random choices\n"
+            "  --rng=KIND                xoshiro (default) or counter random generator\n"
+            "  --engine=ENGINE           threads (default, one thread per agent), events (single-threaded scheduler),\n"
+            "                            pool (work-stealing workers, one per core), soa (lockstep SIMD ticks)\n"
+            "                            or lanes (batch only: 8 houses per SIMD vector, no logs)\n"
+            "  --workers=N               worker threads of the pool engine (default: one per core)\n"
+            "  --layout=FILE             read the house layout from FILE (default: the built-in Willow house)\n"
+            "  --generate=SHAPE:ROOMS[:SEED]  generate the house instead: tree, grid, small-world or corridor\n"
+            "  --hunters=N               N generated hunters (hunter1..hunterN, IDs 1..N) instead of the prompt\n"
+            "  --hunters-file=FILE       read the hunters from FILE, one \"NAME ID\" per line, instead of the prompt\n"
+            "  --batch=N                 run N simulations with the same hunters and print aggregate results\n"
+            "  --jobs=N                  simulations a batch runs at the same time (default 1)\n"
+            "  --batch-log               keep writing log files in batch mode (off by default)\n"
+            "  --verbosity=LEVEL         console output: silent, summary or full (default full)\n"
+            "  --help                    show this message\n",
+            program, LOGQUEUE_DEFAULT_CAPACITY);
+}
+
+// Parse a --log-backpressure value
+static bool parse_backpressure(const char* text, enum LogBackpressure* policy) {
+    if (strcmp(text, "block") == 0) {
+        *policy = LOG_BACKPRESSURE_BLOCK;
+    } else if (strcmp(text, "drop") == 0) {
+        *policy = LOG_BACKPRESSURE_DROP;
+    } else if (strcmp(text, "grow") == 0) {
+        *policy = LOG_BACKPRESSURE_GROW;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Parse a byte count such as 4096, 64K, 10M or 2G of at most max bytes; false on malformed or out-of-range input
+static bool parse_size(const char* text, unsigned long long max, unsigned long long* bytes) {
+    if (strchr(text, '-')) return false; // strtoull would wrap it around
+
+    char* end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text || errno == ERANGE) return false;
+
+    int shift = 0;
+    switch (*end) {
+        case 'G': case 'g': shift += 10; // fall through
+        case 'M': case 'm': shift += 10; // fall through
+        case 'K': case 'k': shift += 10; end++; break;
+        case '\0': break;
+        default: return false;
+    }
+    if (*end != '\0' || value > (max >> shift)) return false;
+
+    *bytes = value << shift;
+    return true;
+}
+
+// Parse a count between 1 and max; false on malformed or out-of-range input
+static bool parse_count(const char* text, long max, long* count) {
+    char* end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value < 1 || value > max) return false;
+
+    *count = value;
+    return true;
+}
+
+// Prompt for hunters until the user types 'done'
+static struct HunterEntry* read_roster(int* count) {
+    struct HunterEntry* roster = NULL;
+    int capacity = 0;
+    char name[MAX_HUNTER_NAME];
+    int id;
+    *count = 0;
+
+    console_summary("Enter hunter name (max 63 characters) or 'done' to finish: ");
+    while (scanf("%63s", name) == 1 && strcmp(name, "done") != 0) {
+        console_summary("Enter hunter ID: ");
+        scanf("%d", &id);
+        if (*count == capacity) {
+            capacity = (capacity == 0 ? 8 : capacity * 2);
+            roster = realloc(roster, capacity * sizeof(struct HunterEntry));
+        }
+        strcpy(roster[*count].name, name);
+        roster[*count].id = id;
+        (*count)++;
+        console_summary("\nEnter next hunter name (max 63 characters) or 'done' to finish: ");
+    }
+    console_summary("\n");
+    return roster;
+}
+
+// Run the batch with the given roster (read interactively when NULL, freed here) and print its aggregate results
+static int run_batch(int runs, int jobs, unsigned long long seed, enum SimEngine engine, int workers,
+                     const struct Layout* layout, struct HunterEntry* roster, int count,
+                     bool with_logs, bool verbosity_chosen,
+                     size_t segment_size, unsigned long long budget, enum LogBudgetPolicy budget_policy,
+                     size_t log_capacity, enum LogBackpressure log_policy) {
+    // Every house has the same layout, so one of them is enough to name the rooms in the logs
+    struct House named;
+    memset(&named, 0, sizeof(named));
+    house_build_layout(&named, layout);
+
+    struct LaneMap map;
+    if (engine == ENGINE_LANES && !lanes_map_init(&map, &named)) {
+        fprintf(stderr, "--engine=lanes supports layouts of up to %d rooms with at most %d connections each\n",
+                LANES_MAX_ROOMS, LANES_MAX_DEGREE);
+        house_free_layout(&named);
+        free(roster);
+        return 1;
+    }
+
+    if (!verbosity_chosen) {
+        console_set_verbosity(CONSOLE_SUMMARY); // Thousands of runs of per-event lines help nobody
+    }
+
+    if (!roster) {
+        roster = read_roster(&count);
+    }
+
+
+    // Console event lines name their rooms through the log house too, with or without log files
+    if (with_logs || console_enabled(CONSOLE_FULL)) {
+        log_attach_house(&named);
+    }
+
+    log_set_enabled(with_logs);
+    if (with_logs) {
+        logsink_set_limits(segment_size, budget, budget_policy);
+        log_start(log_capacity, log_policy);
+    }
+
+    struct BatchStats stats;
+    batch_run(roster, count, runs, jobs, seed, engine, workers, layout, &stats);
+
+    bool logs_written = true;
+    if (with_logs) {
+        logs_written = log_shutdown();
+    }
+
+    batch_print(&stats);
+
+    log_attach_house(NULL);
+    house_free_layout(&named);
+    free(roster);
+    return logs_written ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+
+    static const struct option long_options[] = {
+        {"log-seq",           no_argument,       NULL, 'q'},
+        {"log-format",        required_argument, NULL, 'F'},
+        {"log-backend",       required_argument, NULL, 'W'},
+        {"log-queue",         required_argument, NULL, 'Q'},
+        {"log-backpressure",  required_argument, NULL, 'B'},
+        {"log-segment-size",  required_argument, NULL, 'S'},
+        {"log-budget",        required_argument, NULL, 'G'},
+        {"log-budget-policy", required_argument, NULL, 'P'},
+        {"seed",              required_argument, NULL, 's'},
+        {"rng",               required_argument, NULL, 'r'},
+        {"engine",            required_argument, NULL, 'e'},
+        {"workers",           required_argument, NULL, 'w'},
+        {"layout",            required_argument, NULL, 'H'},
+        {"generate",          required_argument, NULL, 'g'},
+        {"hunters",           required_argument, NULL, 'u'},
+        {"hunters-file",      required_argument, NULL, 'U'},
+        {"batch",             required_argument, NULL, 'n'},
+        {"jobs",              required_argument, NULL, 'j'},
+        {"batch-log",         no_argument,       NULL, 'L'},
+        {"verbosity",         required_argument, NULL, 'v'},
+        {"help",              no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    size_t log_capacity = LOGQUEUE_DEFAULT_CAPACITY;
+    enum LogBackpressure log_policy = LOG_BACKPRESSURE_BLOCK;
+    unsigned long long log_segment_size = 0;
+    unsigned long long log_budget = 0;
+    enum LogBudgetPolicy log_budget_policy = LOG_BUDGET_STOP;
+    int batch_runs = 0;
+    int batch_jobs = 1;
+    bool batch_log = false;
+    bool verbosity_chosen = false;
+    unsigned long long seed = rng_entropy_seed();
+    enum SimEngine engine = ENGINE_THREADS;
+    int workers = 0;
+    struct Layout loaded = {0}; // Rooms read with --layout or made by --generate
+    const struct Layout* layout = layout_willow();
+    struct HunterEntry* roster = NULL; // Hunters from --hunters or --hunters-file; prompted for otherwise
+    int roster_count = 0;
+
+    // Command-line options
+    int opt;
+    long count; // Parsed numeric option value
+    while ((opt = getopt_long(argc, argv, "h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'q':
+                log_set_sequence_column(true);
+                break;
+            case 'F':
+                if (strcmp(optarg, "csv") == 0) {
+                    log_set_format(LOG_FORMAT_CSV);
+                } else if (strcmp(optarg, "binary") == 0) {
+                    log_set_format(LOG_FORMAT_BINARY);
+                } else {
+                    fprintf(stderr, "Invalid --log-format value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'W':
+                if (strcmp(optarg, "write") == 0) {
+                    logsink_set_backend(LOGSINK_BACKEND_WRITE);
+                } else if (strcmp(optarg, "mmap") == 0) {
+                    logsink_set_backend(LOGSINK_BACKEND_MMAP);
+                } else if (strcmp(optarg, "io_uring") == 0) {
+                    if (!logsink_set_backend(LOGSINK_BACKEND_URING)) {
+                        fprintf(stderr, "io_uring is not available; using the write backend.\n");
+                    }
+                } else {
+                    fprintf(stderr, "Invalid --log-backend value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'Q':
+                if (!parse_count(optarg, (long)LOGQUEUE_MAX_CAPACITY, &count)) {
+                    fprintf(stderr, "Invalid --log-queue value: %s\n", optarg);
+                    return 1;
+                }
+                log_capacity = (size_t)count;
+                break;
+            case 'B':
+                if (!parse_backpressure(optarg, &log_policy)) {
+                    fprintf(stderr, "Invalid --log-backpressure value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'S':
+                if (!parse_size(optarg, SIZE_MAX, &log_segment_size)) {
+                    fprintf(stderr, "Invalid --log-segment-size value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'G':
+                if (!parse_size(optarg, ULLONG_MAX, &log_budget)) {
+                    fprintf(stderr, "Invalid --log-budget value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'P':
+                if (strcmp(optarg, "stop") == 0) {
+                    log_budget_policy = LOG_BUDGET_STOP;
+                } else if (strcmp(optarg, "delete-oldest") == 0) {
+                    log_budget_policy = LOG_BUDGET_DELETE_OLDEST;
+                } else {
+                    fprintf(stderr, "Invalid --log-budget-policy value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 's': {
+                char* end;
+                errno = 0;
+                seed = strtoull(optarg, &end, 0);
+                // strtoull would wrap a negative seed around
+                if (strchr(optarg, '-') || end == optarg || *end != '\0' || errno == ERANGE) {
+                    fprintf(stderr, "Invalid --seed value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            }
+            case 'r':
+                if (strcmp(optarg, "xoshiro") == 0) {
+                    rng_set_kind(RNG_XOSHIRO256SS);
+                } else if (strcmp(optarg, "counter") == 0) {
+                    rng_set_kind(RNG_COUNTER);
+                } else {
+                    fprintf(stderr, "Invalid --rng value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'e':
+                if (strcmp(optarg, "threads") == 0) {
+                    engine = ENGINE_THREADS;
+                } else if (strcmp(optarg, "events") == 0) {
+                    engine = ENGINE_EVENTS;
+                } else if (strcmp(optarg, "pool") == 0) {
+                    engine = ENGINE_POOL;
+                } else if (strcmp(optarg, "soa") == 0) {
+                    engine = ENGINE_SOA;
+                } else if (strcmp(optarg, "lanes") == 0) {
+                    engine = ENGINE_LANES;
+                } else {
+                    fprintf(stderr, "Invalid --engine value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'w':
+                if (!parse_count(optarg, INT_MAX, &count)) {
+                    fprintf(stderr, "Invalid --workers value: %s\n", optarg);
+                    return 1;
+                }
+                workers = (int)count;
+                break;
+            case 'H':
+                layout_free(&loaded);
+                if (!layout_load(&loaded, optarg)) {
+                    return 1;
+                }
+                layout = &loaded;
+                break;
+            case 'g':
+                layout_free(&loaded);
+                if (!layout_generate_spec(&loaded, optarg)) {
+                    fprintf(stderr, "Invalid --generate value: %s\n", optarg);
+                    return 1;
+                }
+                layout = &loaded;
+                break;
+            case 'u':
+                if (!parse_count(optarg, INT_MAX, &count)) {
+                    fprintf(stderr, "Invalid --hunters value: %s\n", optarg);
+                    return 1;
+                }
+                roster_count = (int)count;
+                free(roster);
+                roster = roster_generate(roster_count);
+                break;
+            case 'U':
+                free(roster);
+                roster = roster_load(optarg, &roster_count);
+                if (!roster) {
+                    return 1;
+                }
+                break;
+            case 'n':
+                if (!parse_count(optarg, INT_MAX, &count)) {
+                    fprintf(stderr, "Invalid --batch value: %s\n", optarg);
+                    return 1;
+                }
+                batch_runs = (int)count;
+                break;
+            case 'j':
+                if (!parse_count(optarg, INT_MAX, &count)) {
+                    fprintf(stderr, "Invalid --jobs value: %s\n", optarg);
+                    return 1;
+                }
+                batch_jobs = (int)count;
+                break;
+            case 'L':
+                batch_log = true;
+                break;
+            case 'v':
+                verbosity_chosen = true;
+                if (strcmp(optarg, "silent") == 0) {
+                    console_set_verbosity(CONSOLE_SILENT);
+                } else if (strcmp(optarg, "summary") == 0) {
+                    console_set_verbosity(CONSOLE_SUMMARY);
+                } else if (strcmp(optarg, "full") == 0) {
+                    console_set_verbosity(CONSOLE_FULL);
+                } else {
+                    fprintf(stderr, "Invalid --verbosity value: %s\n", optarg);
+                    return 1;
+                }
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (engine == ENGINE_LANES && batch_runs == 0) {
+        fprintf(stderr, "--engine=lanes needs --batch\n");
+        return 1;
+    }
+
+    if (batch_runs > 0) {
+        int status = run_batch(batch_runs, batch_jobs, seed, engine, workers, layout, roster, roster_count,
+                               batch_log, verbosity_chosen,
+                               (size_t)log_segment_size, log_budget, log_budget_policy, log_capacity, log_policy);
+        layout_free(&loaded);
+        return status;
+    }
 
     struct House house;
     memset(&house, 0, sizeof(house)); // Clear all fields in House
 
-    house_populate_rooms(&house); // Build all rooms and map layout
+    house_build_layout(&house, layout); // Build all rooms and map layout
+    house.seed = seed; // Ghost and hunters derive their random streams from it
+    house.engine = engine;
+    house.workers = workers;
+
+    log_attach_house(&house); // Log records refer to rooms by index
+    logsink_set_limits((size_t)log_segment_size, log_budget, log_budget_policy);
+    log_start(log_capacity, log_policy); // Agent threads only enqueue records from here on
 
-    sem_init(&house.fileCase.mutex, 0, 1); // Init CaseFile mutex
-    house.fileCase.collected = 0; // No evidence collected yet
-    house.fileCase.solved = false; // Case not solved
+    casefile_init(&house.fileCase); // No evidence collected yet
 
     house.hunter = NULL; // Dynamic array starts empty
     house.hunterCount = 0;
@@ -21,10 +430,7 @@ int main() {
 
     ghost_init(&house.ghost, &house); // Randomize ghost type + start room
 
-    char name[MAX_HUNTER_NAME];
-    int id;
-
-    printf(
+    console_summary(
         "\033[31m"
         "=====================================\n"
         "||   GHOST HOUSE INVESTIGATION!    ||\n"
@@ -33,38 +439,19 @@ int main() {
         "\n"
     );
 
-    printf("Enter hunter name (max 63 characters) or 'done' to finish: ");
-
-    // User input loop for hunters
-    while (scanf("%63s", name) == 1 && strcmp(name, "done") != 0) {
-        printf("Enter hunter ID: ");
-        scanf("%d", &id);
-        hunter_add(&house, name, id); // Add hunter to House
-        printf("\nEnter next hunter name (max 63 characters) or 'done' to finish: ");
-    }
-
-    // Thread creation
-    pthread_t ghostThread;
-    pthread_create(&ghostThread, NULL, ghost_thread, &house.ghost);
-    
-    // Create one thread per hunter
-    pthread_t* hunterThreads = malloc(sizeof(pthread_t) * house.hunterCount);
-
-    for (int i = 0; i < house.hunterCount; i++) {
-        pthread_create(&hunterThreads[i], NULL, hunter_thread, &house.hunter[i]);
+    if (!roster) {
+        roster = read_roster(&roster_count);
     }
+    house_add_roster(&house, roster, roster_count); // One allocation for every hunter
+    free(roster);
+    console_flush_thread(); // The hunters' INIT lines come before any simulation event
 
-    // Thread join
-    for (int i = 0; i < house.hunterCount; i++) {
-        pthread_join(hunterThreads[i], NULL); // Wait for hunter to finish
-        roomstack_clear(&house.hunter[i].path); // Free breadcrumb stack
-    }
+    house_simulate(&house); // One thread per agent, joined before returning
 
-    // Wait for ghost thread
-    pthread_join(ghostThread, NULL);
+    bool logs_written = log_shutdown(); // Drain the log writer and close every log file
 
     // Final output
-    printf(
+    console_summary(
         "\n"
         "\033[31m"
         "=========================\n"
@@ -80,26 +467,26 @@ int main() {
 
         const char* reason = exit_reason_to_string(h->whyExit);
 
-        printf("[✗] Hunter %s (ID %d) exited because of [%s] (bored=%d fear=%d).\n",
-               h->name, h->id, reason, h->boredom, h->fear);
+        console_summary("[✗] Hunter %s (ID %d) exited because of [%s] (bored=%d fear=%d).\n",
+                        h->name, h->id, reason, h->boredom, h->fear);
     }
 
     // Evidence Checklist
-    printf("\nShared Case File Checklist:\n");
+    console_summary("\nShared Case File Checklist:\n");
 
-    EvidenceByte mask = house.fileCase.collected;
+    EvidenceByte mask = casefile_collected(&house.fileCase);
 
-    printf(" - [%s] emf\n",      (mask & EV_EMF)          ? "\033[32m✔\033[0m" : " ");
-    printf(" - [%s] orbs\n",     (mask & EV_ORBS)         ? "\033[32m✔\033[0m" : " ");
-    printf(" - [%s] radio\n",    (mask & EV_RADIO)        ? "\033[32m✔\033[0m" : " ");
-    printf(" - [%s] temp\n",     (mask & EV_TEMPERATURE)  ? "\033[32m✔\033[0m" : " ");
-    printf(" - [%s] prints\n",   (mask & EV_FINGERPRINTS) ? "\033[32m✔\033[0m" : " ");
-    printf(" - [%s] writing\n",  (mask & EV_WRITING)      ? "\033[32m✔\033[0m" : " ");
-    printf(" - [%s] infrared\n", (mask & EV_INFRARED)     ? "\033[32m✔\033[0m" : " ");
+    console_summary(" - [%s] emf\n",      (mask & EV_EMF)          ? "\033[32m✔\033[0m" : " ");
+    console_summary(" - [%s] orbs\n",     (mask & EV_ORBS)         ? "\033[32m✔\033[0m" : " ");
+    console_summary(" - [%s] radio\n",    (mask & EV_RADIO)        ? "\033[32m✔\033[0m" : " ");
+    console_summary(" - [%s] temp\n",     (mask & EV_TEMPERATURE)  ? "\033[32m✔\033[0m" : " ");
+    console_summary(" - [%s] prints\n",   (mask & EV_FINGERPRINTS) ? "\033[32m✔\033[0m" : " ");
+    console_summary(" - [%s] writing\n",  (mask & EV_WRITING)      ? "\033[32m✔\033[0m" : " ");
+    console_summary(" - [%s] infrared\n", (mask & EV_INFRARED)     ? "\033[32m✔\033[0m" : " ");
 
 
     // Victory Results
-    printf(
+    console_summary(
         "\n"
         "\033[35m"
         "=========================\n"
@@ -115,27 +502,30 @@ int main() {
             exits_after_solve++;
     }
 
-    printf("- Hunters exited after identifying the ghost: %d/%d\n",
-           exits_after_solve, house.hunterCount);
+    console_summary("- Hunters exited after identifying the ghost: %d/%d\n",
+                    exits_after_solve, house.hunterCount);
 
-    printf("- Ghost Guess: N/A\n");
-    printf("- Actual Ghost Type: %s\n", ghost_to_string(house.ghost.ghostType));
+    const struct GhostDeduction* deduction = ghost_deduce(mask);
+    if (deduction->guess >= 0) {
+        const enum GhostType* types;
+        get_all_ghost_types(&types);
+        console_summary("- Ghost Guess: %s\n", ghost_to_string(types[deduction->guess]));
+    } else {
+        console_summary("- Ghost Guess: N/A (%d candidate%s)\n", deduction->count, deduction->count == 1 ? "" : "s");
+    }
+    console_summary("- Actual Ghost Type: %s\n", ghost_to_string(house.ghost.ghostType));
+    console_summary("- Seed: %llu\n", house.seed);
 
     // Final colored win/lose message
     if (exits_after_solve > 0) {
-        printf("\nOverall Result: \033[32mHunters Win!\033[0m\n");
+        console_summary("\nOverall Result: \033[32mHunters Win!\033[0m\n");
     } else {
-        printf("\nOverall Result: \033[31mGhost Wins!\033[0m\n");
+        console_summary("\nOverall Result: \033[31mGhost Wins!\033[0m\n");
     }
 
     // Cleanup
-    for (int i = 0; i < house.room_count; i++) {
-        sem_destroy(&house.rooms[i].mutex);
-    }
-    sem_destroy(&house.fileCase.mutex);
-
-    free(hunterThreads);
-    free(house.hunter);
+    house_cleanup(&house);
+    layout_free(&loaded);
 
-    return 0;
+    return logs_written ? 0 : 1; // Lost log data was reported on stderr
 }
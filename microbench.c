@@ -0,0 +1,365 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "defs.h"
+#include "helpers.h"
+#include "console.h"
+#include "logsink.h"
+#include "batch.h"
+#include "layout.h"
+
+#define MICROBENCH_HUNTERS 64 // Hunters in the house the occupancy benchmarks move around
+
+// One primitive to time: setup and teardown run outside the timed region of every trial
+struct Bench {
+    const char* name;
+    long ops; // Operations per trial
+    void (*setup)(void);
+    void (*run)(long ops);
+    void (*teardown)(void);
+};
+
+static struct House house; // Willow with MICROBENCH_HUNTERS hunters in the van
+static struct Rng rng;
+static int contention_threads = 4;
+static volatile unsigned long long sink; // Results land here so no loop is optimized away
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--trials=N] [--warmup=N] [--threads=N] [--filter=TEXT] [--dir=DIR]\n"
+            "Times the simulation's hot primitives in isolation and reports ns/op percentiles over the trials.\n"
+            "  --trials=N    timed trials per benchmark (default 25)\n"
+            "  --warmup=N    untimed trials before them (default 3)\n"
+            "  --threads=N   threads fighting over one room semaphore in the contention benchmark (default 4)\n"
+            "  --filter=TEXT only run benchmarks whose name contains TEXT\n"
+            "  --dir=DIR     scratch directory for the log files (default: a new directory in /tmp)\n",
+            program);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted values
+static double percentile(const double* sorted, int count, int pct) {
+    int rank = (pct * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// ---- Logging ----
+
+// Records go through the writer thread as in a run; only the agent-side cost is timed
+static void logs_on(void) {
+    log_set_enabled(true);
+    log_start(LOGQUEUE_DEFAULT_CAPACITY, LOG_BACKPRESSURE_BLOCK);
+}
+
+static void logs_drain(void) {
+    log_shutdown();
+    char path[64];
+    snprintf(path, sizeof(path), "log_%d.csv", 1);
+    unlink(path);
+    snprintf(path, sizeof(path), "log_%d.csv", DEFAULT_GHOST_ID);
+    unlink(path);
+}
+
+static void logs_off(void) {
+    log_set_enabled(false);
+}
+
+static void run_log_move(long ops) {
+    for (long i = 0; i < ops; i++) log_move(1, (int)i & 15, 3, 1, 2, EV_EMF);
+}
+
+static void run_log_evidence(long ops) {
+    for (long i = 0; i < ops; i++) log_evidence(1, (int)i & 15, 3, 1, EV_ORBS);
+}
+
+static void run_log_swap(long ops) {
+    for (long i = 0; i < ops; i++) log_swap(1, (int)i & 15, 3, EV_EMF, EV_RADIO);
+}
+
+static void run_log_exit(long ops) {
+    for (long i = 0; i < ops; i++) log_exit(1, (int)i & 15, 3, 0, EV_EMF, LR_BORED);
+}
+
+static void run_log_return_to_van(long ops) {
+    for (long i = 0; i < ops; i++) log_return_to_van(1, (int)i & 15, 3, 1, EV_EMF, i & 1);
+}
+
+static void run_log_hunter_init(long ops) {
+    for (long i = 0; i < ops; i++) log_hunter_init(1, 0, "hunter1", EV_WRITING);
+}
+
+static void run_log_ghost_init(long ops) {
+    for (long i = 0; i < ops; i++) log_ghost_init(DEFAULT_GHOST_ID, 3, GH_BANSHEE);
+}
+
+static void run_log_ghost_move(long ops) {
+    for (long i = 0; i < ops; i++) log_ghost_move(DEFAULT_GHOST_ID, (int)i & 15, 1, 9);
+}
+
+static void run_log_ghost_evidence(long ops) {
+    for (long i = 0; i < ops; i++) log_ghost_evidence(DEFAULT_GHOST_ID, (int)i & 15, 1, EV_INFRARED);
+}
+
+static void run_log_ghost_exit(long ops) {
+    for (long i = 0; i < ops; i++) log_ghost_exit(DEFAULT_GHOST_ID, (int)i & 15, 1);
+}
+
+static void run_log_ghost_idle(long ops) {
+    for (long i = 0; i < ops; i++) log_ghost_idle(DEFAULT_GHOST_ID, (int)i & 15, 1);
+}
+
+// ---- Random streams ----
+
+static void run_rng_next(long ops) {
+    unsigned long long total = 0;
+    for (long i = 0; i < ops; i++) total += rng_next(&rng);
+    sink = total;
+}
+
+static void run_rng_range(long ops) {
+    unsigned long long total = 0;
+    for (long i = 0; i < ops; i++) total += (unsigned)rng_range(&rng, 0, 6);
+    sink = total;
+}
+
+// ---- Rooms ----
+
+// Move hunters between the van and the hallway: remove from one room, add to the other
+static void run_occupancy(long ops) {
+    for (long i = 0; i < ops; i++) {
+        struct Hunter* hunt = &house.hunter[i % MICROBENCH_HUNTERS];
+        struct Room* to = &house.rooms[hunt->current == house.rooms ? 1 : 0];
+        room_remove_hunter(hunt->current, hunt);
+        room_add_hunter(to, hunt);
+        hunt->current = to;
+    }
+}
+
+// The same move with the room semaphores taken as hunter_step() does in the threaded engines
+static void run_occupancy_locked(long ops) {
+    for (long i = 0; i < ops; i++) {
+        struct Hunter* hunt = &house.hunter[i % MICROBENCH_HUNTERS];
+        struct Room* from = hunt->current;
+        struct Room* to = &house.rooms[from == house.rooms ? 1 : 0];
+
+        sem_wait(&from->mutex);
+        room_remove_hunter(from, hunt);
+        sem_post(&from->mutex);
+
+        sem_wait(&to->mutex);
+        room_add_hunter(to, hunt);
+        sem_post(&to->mutex);
+        hunt->current = to;
+    }
+}
+
+static void run_sem_uncontended(long ops) {
+    sem_t* mutex = &house.rooms[1].mutex;
+    for (long i = 0; i < ops; i++) {
+        sem_wait(mutex);
+        sem_post(mutex);
+    }
+}
+
+static long contention_ops;
+
+static void* contention_thread(void* arg) {
+    (void)arg;
+    sem_t* mutex = &house.rooms[1].mutex;
+    for (long i = 0; i < contention_ops; i++) {
+        sem_wait(mutex);
+        sink++;
+        sem_post(mutex);
+    }
+    return NULL;
+}
+
+// Every thread hammers the same room semaphore; ops are shared out between them
+static void run_sem_contended(long ops) {
+    contention_ops = ops / contention_threads;
+    pthread_t threads[contention_threads];
+    for (int i = 0; i < contention_threads; i++) {
+        pthread_create(&threads[i], NULL, contention_thread, NULL);
+    }
+    for (int i = 0; i < contention_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// ---- Evidence ----
+
+static void run_three_unique(long ops) {
+    unsigned long long total = 0;
+    for (long i = 0; i < ops; i++) total += evidence_has_three_unique((EvidenceByte)(i & 127));
+    sink = total;
+}
+
+static void run_valid_ghost(long ops) {
+    unsigned long long total = 0;
+    for (long i = 0; i < ops; i++) total += evidence_is_valid_ghost((EvidenceByte)(i & 127));
+    sink = total;
+}
+
+static void run_ghost_deduce(long ops) {
+    unsigned long long total = 0;
+    for (long i = 0; i < ops; i++) total += ghost_deduce((EvidenceByte)(i & 127))->candidates;
+    sink = total;
+}
+
+static void run_casefile(long ops) {
+    unsigned long long total = 0;
+    for (long i = 0; i < ops; i++) {
+        casefile_add(&house.fileCase, (EvidenceByte)(1 << (i % 7)));
+        total += casefile_solved(&house.fileCase);
+    }
+    sink = total;
+}
+
+// Trials of one benchmark: warmup first, then the timed ones
+static void bench_run(const struct Bench* bench, int warmup, int trials, const char* filter) {
+    if (filter && !strstr(bench->name, filter)) return;
+
+    double* ns = malloc(sizeof(double) * trials);
+    for (int t = -warmup; t < trials; t++) {
+        if (bench->setup) bench->setup();
+        double start = now_seconds();
+        bench->run(bench->ops);
+        double elapsed = now_seconds() - start;
+        if (bench->teardown) bench->teardown();
+
+        if (t >= 0) ns[t] = elapsed * 1e9 / (double)bench->ops;
+    }
+
+    qsort(ns, trials, sizeof(double), compare_doubles);
+    printf("%-26s %9.1f %9.1f %9.1f %9.1f %9.1f\n", bench->name,
+           ns[0], percentile(ns, trials, 50), percentile(ns, trials, 90), percentile(ns, trials, 99), ns[trials - 1]);
+    free(ns);
+}
+
+int main(int argc, char** argv) {
+    static const struct option long_options[] = {
+        {"trials",  required_argument, NULL, 't'},
+        {"warmup",  required_argument, NULL, 'w'},
+        {"threads", required_argument, NULL, 'T'},
+        {"filter",  required_argument, NULL, 'f'},
+        {"dir",     required_argument, NULL, 'd'},
+        {"help",    no_argument,       NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int trials = 25;
+    int warmup = 3;
+    const char* filter = NULL;
+    const char* directory = NULL;
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "h", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 't':
+                trials = (int)strtol(optarg, NULL, 10);
+                break;
+            case 'w':
+                warmup = (int)strtol(optarg, NULL, 10);
+                break;
+            case 'T':
+                contention_threads = (int)strtol(optarg, NULL, 10);
+                break;
+            case 'f':
+                filter = optarg;
+                break;
+            case 'd':
+                directory = optarg;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return 0;
+            default:
+                print_usage(argv[0]);
+                return 1;
+        }
+    }
+    if (trials <= 0 || warmup < 0 || contention_threads <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    char scratch[] = "/tmp/ghostbench.XXXXXX";
+    if (!directory) {
+        directory = mkdtemp(scratch);
+        if (!directory) {
+            perror("mkdtemp");
+            return 1;
+        }
+    }
+    if (chdir(directory) != 0) {
+        perror(directory);
+        return 1;
+    }
+
+    // Only the primitives are timed: no console lines, logs only where a benchmark starts them
+    console_set_verbosity(CONSOLE_SILENT);
+    log_set_enabled(false);
+
+    house_build_layout(&house, layout_willow());
+    house.engine = ENGINE_THREADS;
+    casefile_init(&house.fileCase);
+    struct HunterEntry* roster = roster_generate(MICROBENCH_HUNTERS);
+    house_add_roster(&house, roster, MICROBENCH_HUNTERS);
+    free(roster);
+    log_attach_house(&house);
+    rng_seed(&rng, 1, RNG_STREAM_RUN, 0);
+
+    char contended[32];
+    snprintf(contended, sizeof(contended), "room sem contended x%d", contention_threads);
+
+    const struct Bench benches[] = {
+        {"log_move (logs off)",     1000000, logs_off, run_log_move,           NULL},
+        {"log_move",                  20000, logs_on,  run_log_move,           logs_drain},
+        {"log_evidence",              20000, logs_on,  run_log_evidence,       logs_drain},
+        {"log_swap",                  20000, logs_on,  run_log_swap,           logs_drain},
+        {"log_exit",                  20000, logs_on,  run_log_exit,           logs_drain},
+        {"log_return_to_van",         20000, logs_on,  run_log_return_to_van, logs_drain},
+        {"log_hunter_init",           20000, logs_on,  run_log_hunter_init,    logs_drain},
+        {"log_ghost_init",            20000, logs_on,  run_log_ghost_init,     logs_drain},
+        {"log_ghost_move",            20000, logs_on,  run_log_ghost_move,     logs_drain},
+        {"log_ghost_evidence",        20000, logs_on,  run_log_ghost_evidence, logs_drain},
+        {"log_ghost_exit",            20000, logs_on,  run_log_ghost_exit,     logs_drain},
+        {"log_ghost_idle",            20000, logs_on,  run_log_ghost_idle,     logs_drain},
+        {"rng_next",               10000000, NULL,     run_rng_next,           NULL},
+        {"rng_range",              10000000, NULL,     run_rng_range,          NULL},
+        {"occupancy move",          1000000, NULL,     run_occupancy,          NULL},
+        {"occupancy move locked",   1000000, NULL,     run_occupancy_locked,   NULL},
+        {"room sem uncontended",    1000000, NULL,     run_sem_uncontended,    NULL},
+        {contended,                 1000000, NULL,     run_sem_contended,      NULL},
+        {"evidence_has_three_unique", 10000000, NULL,  run_three_unique,       NULL},
+        {"evidence_is_valid_ghost", 10000000, NULL,    run_valid_ghost,        NULL},
+        {"ghost_deduce",           10000000, NULL,     run_ghost_deduce,       NULL},
+        {"casefile add+solved",    10000000, NULL,     run_casefile,           NULL},
+    };
+
+    printf("%d trials after %d warmup, ns/op\n", trials, warmup);
+    printf("%-26s %9s %9s %9s %9s %9s\n", "benchmark", "min", "p50", "p90", "p99", "max");
+    for (size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        bench_run(&benches[i], warmup, trials, filter);
+    }
+
+    house_cleanup(&house);
+    if (directory == scratch) {
+        rmdir(scratch);
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "pool.h"
+#include "logsink.h"
+#include "console.h"
+
+#define POOL_GHOST -1 // Agent index of the ghost; hunters use their array index
+#define POOL_EMPTY -2 // Deque had nothing to give
+#define POOL_ABORT -3 // Lost a race with another thief, try again
+
+// Chase-Lev work-stealing deque: the owner pushes and takes at the bottom, thieves steal at the top
+struct PoolDeque {
+    _Alignas(64) _Atomic long top;
+    _Alignas(64) _Atomic long bottom;
+    long mask;
+    _Atomic int* items;
+};
+
+// One worker: this tick's deque and the one it fills for the next tick
+struct PoolWorker {
+    struct PoolDeque deques[2];
+    int index;
+    struct Pool* pool;
+    pthread_t thread;
+};
+
+struct Pool {
+    struct House* house;
+    struct PoolWorker* workers;
+    int worker_count;
+    int tick; // Parity selects which deque of each worker is current
+    _Atomic long remaining; // Turns of the current tick not yet taken
+    _Atomic long next_count; // Agents requeued for the next tick
+    bool done;
+    pthread_barrier_t barrier;
+};
+
+// ---- Deque ----
+static void deque_init(struct PoolDeque* deque, long capacity) {
+    long size = 2;
+    while (size < capacity) size <<= 1;
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    deque->mask = size - 1;
+    deque->items = malloc(sizeof(_Atomic int) * size);
+}
+
+// Owner only; capacity covers every agent, so it never overflows
+static void deque_push(struct PoolDeque* deque, int agent) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    atomic_store_explicit(&deque->items[bottom & deque->mask], agent, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+// Owner only
+static int deque_take(struct PoolDeque* deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return POOL_EMPTY;
+    }
+
+    int agent = atomic_load_explicit(&deque->items[bottom & deque->mask], memory_order_relaxed);
+    if (top == bottom) {
+        // Last item: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            agent = POOL_EMPTY;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return agent;
+}
+
+// Any thread
+static int deque_steal(struct PoolDeque* deque) {
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    if (top >= bottom) return POOL_EMPTY;
+
+    int agent = atomic_load_explicit(&deque->items[top & deque->mask], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return POOL_ABORT;
+    }
+    return agent;
+}
+
+// ---- Workers ----
+static bool agent_step(struct House* house, int agent) {
+    return agent == POOL_GHOST ? ghost_step(&house->ghost) : hunter_step(&house->hunter[agent]);
+}
+
+// Next agent of the current tick: own deque first, then the other workers'
+static int worker_next(struct PoolWorker* self) {
+    struct Pool* pool = self->pool;
+    int current = pool->tick & 1;
+
+    int agent = deque_take(&self->deques[current]);
+    if (agent != POOL_EMPTY) return agent;
+
+    for (int offset = 1; offset < pool->worker_count; offset++) {
+        struct PoolWorker* victim = &pool->workers[(self->index + offset) % pool->worker_count];
+        do {
+            agent = deque_steal(&victim->deques[current]);
+        } while (agent == POOL_ABORT);
+        if (agent != POOL_EMPTY) return agent;
+    }
+    return POOL_EMPTY;
+}
+
+static void* worker_main(void* arg) {
+    struct PoolWorker* self = arg;
+    struct Pool* pool = self->pool;
+
+    for (;;) {
+        int next = (pool->tick + 1) & 1;
+
+        // Take turns until every agent of this tick has had one
+        while (atomic_load_explicit(&pool->remaining, memory_order_acquire) > 0) {
+            int agent = worker_next(self);
+            if (agent == POOL_EMPTY) {
+                sched_yield(); // The last turns are running on other workers
+                continue;
+            }
+
+            if (agent_step(pool->house, agent)) {
+                deque_push(&self->deques[next], agent);
+                atomic_fetch_add_explicit(&pool->next_count, 1, memory_order_relaxed);
+            }
+            atomic_fetch_sub_explicit(&pool->remaining, 1, memory_order_release);
+        }
+
+        // One worker sets up the next tick while the others wait
+        if (pthread_barrier_wait(&pool->barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+            long count = atomic_exchange(&pool->next_count, 0);
+            pool->done = (count == 0);
+            pool->tick++;
+            atomic_store(&pool->remaining, count);
+        }
+        pthread_barrier_wait(&pool->barrier);
+
+        if (pool->done) break;
+    }
+
+    logsink_flush_thread(); // Push this worker's buffered log lines to disk
+    console_flush_thread(); // And its pending console lines to stdout
+    return NULL;
+}
+
+// ---- Public interface ----
+void pool_simulate(struct House* house) {
+    int workers = house->workers;
+    if (workers <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cores > 0 ? (int)cores : 1;
+    }
+    long agents = house->hunterCount + 1;
+
+    struct Pool pool = {
+        .house = house,
+        .workers = calloc(workers, sizeof(struct PoolWorker)),
+        .worker_count = workers,
+        .tick = 0,
+        .done = false
+    };
+    atomic_init(&pool.remaining, agents);
+    atomic_init(&pool.next_count, 0);
+    pthread_barrier_init(&pool.barrier, NULL, (unsigned)workers);
+
+    for (int i = 0; i < workers; i++) {
+        pool.workers[i].index = i;
+        pool.workers[i].pool = &pool;
+        deque_init(&pool.workers[i].deques[0], agents);
+        deque_init(&pool.workers[i].deques[1], agents);
+    }
+
+    // Deal the agents out round-robin before any worker runs
+    deque_push(&pool.workers[0].deques[0], POOL_GHOST);
+    for (int i = 0; i < house->hunterCount; i++) {
+        deque_push(&pool.workers[(i + 1) % workers].deques[0], i);
+    }
+
+    for (int i = 0; i < workers; i++) {
+        pthread_create(&pool.workers[i].thread, NULL, worker_main, &pool.workers[i]);
+    }
+    for (int i = 0; i < workers; i++) {
+        pthread_join(pool.workers[i].thread, NULL);
+    }
+
+    for (int i = 0; i < workers; i++) {
+        free(pool.workers[i].deques[0].items);
+        free(pool.workers[i].deques[1].items);
+    }
+    pthread_barrier_destroy(&pool.barrier);
+    free(pool.workers);
+}
@@ -0,0 +1,18 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "defs.h"
+
+/**
+ * @brief Run every agent of a house on a fixed pool of worker threads.
+ * @param[in,out] house Populated house; house->workers threads are used (0 = one per core).
+ *
+ * Agents are not threads: each worker keeps a work-stealing deque of agent
+ * indices, runs one step of an agent and requeues it while it is active.
+ * Steps happen in ticks, every active agent taking exactly one turn per tick,
+ * and idle workers steal from the others. Rooms and the case file stay
+ * guarded by their semaphores because steps run concurrently.
+ */
+void pool_simulate(struct House* house);
+
+#endif // POOL_H
@@ -0,0 +1,96 @@
+#include <time.h>
+#include <unistd.h>
+#include "rng.h"
+
+#define GOLDEN_GAMMA 0x9E3779B97F4A7C15ull
+
+static enum RngKind rng_kind = RNG_XOSHIRO256SS;
+
+// ---- SplitMix64 ----
+static uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint64_t splitmix64(uint64_t* state) {
+    *state += GOLDEN_GAMMA;
+    return mix64(*state);
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// ---- Seeding ----
+void rng_set_kind(enum RngKind kind) {
+    rng_kind = kind;
+}
+
+uint64_t rng_entropy_seed(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t state = ((uint64_t)ts.tv_sec << 32) ^ (uint64_t)ts.tv_nsec ^ ((uint64_t)getpid() << 16);
+    return splitmix64(&state);
+}
+
+uint64_t rng_derive(uint64_t seed, enum RngStreamKind kind, int64_t id) {
+    // Two mixing rounds so nearby IDs and seeds land far apart
+    uint64_t state = mix64(seed ^ ((uint64_t)kind * GOLDEN_GAMMA));
+    state ^= (uint64_t)id;
+    return splitmix64(&state);
+}
+
+void rng_seed(struct Rng* rng, uint64_t seed, enum RngStreamKind kind, int64_t id) {
+    uint64_t state = rng_derive(seed, kind, id);
+    rng->kind = rng_kind;
+
+    if (rng->kind == RNG_COUNTER) {
+        rng->state[0] = splitmix64(&state); // Key
+        rng->state[1] = 0; // Counter
+        rng->state[2] = rng->state[3] = 0;
+    } else {
+        // SplitMix64 expansion never yields the all-zero xoshiro state
+        for (int i = 0; i < 4; i++) rng->state[i] = splitmix64(&state);
+    }
+}
+
+// ---- Generation ----
+uint64_t rng_next(struct Rng* rng) {
+    uint64_t* s = rng->state;
+
+    if (rng->kind == RNG_COUNTER) {
+        // Output depends only on key and position, so any draw can be recomputed
+        return mix64(s[0] + (s[1]++ + 1) * GOLDEN_GAMMA);
+    }
+
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+int rng_range(struct Rng* rng, int lower_inclusive, int upper_exclusive) {
+    if (upper_exclusive <= lower_inclusive) {
+        return lower_inclusive;
+    }
+
+    uint32_t span = (uint32_t)((int64_t)upper_exclusive - lower_inclusive);
+    uint64_t product = (rng_next(rng) >> 32) * span;
+    uint32_t low = (uint32_t)product;
+
+    if (low < span) {
+        // Reject the few values that would make some results more likely
+        uint32_t threshold = (uint32_t)(-span) % span;
+        while (low < threshold) {
+            product = (rng_next(rng) >> 32) * span;
+            low = (uint32_t)product;
+        }
+    }
+    return lower_inclusive + (int)(product >> 32);
+}
@@ -0,0 +1,73 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Generators a stream can use
+enum RngKind {
+    RNG_XOSHIRO256SS = 0, // xoshiro256** (default)
+    RNG_COUNTER           // Counter-based: SplitMix64 output function over key + counter
+};
+
+// Kinds of streams derived from a master seed, so equal IDs never share one
+enum RngStreamKind {
+    RNG_STREAM_HUNTER = 0,
+    RNG_STREAM_GHOST,
+    RNG_STREAM_RUN,
+    RNG_STREAM_SCHEDULER,
+    RNG_STREAM_LAYOUT
+};
+
+// One independent random stream, owned by a single entity (no locking)
+struct Rng {
+    uint64_t state[4]; // xoshiro state, or key and counter for RNG_COUNTER
+    enum RngKind kind;
+};
+
+/**
+ * @brief Select the generator used by streams seeded afterwards.
+ * @param[in] kind Generator kind; set before the first rng_seed().
+ */
+void rng_set_kind(enum RngKind kind);
+
+/**
+ * @brief Make up a master seed from the clock and process ID.
+ * @return A seed that differs between invocations.
+ */
+uint64_t rng_entropy_seed(void);
+
+/**
+ * @brief Derive the seed of an independent stream.
+ * @param[in] seed Master seed.
+ * @param[in] kind What the stream belongs to.
+ * @param[in] id Entity ID or run index.
+ * @return Well mixed 64-bit seed; the same inputs always give the same value.
+ */
+uint64_t rng_derive(uint64_t seed, enum RngStreamKind kind, int64_t id);
+
+/**
+ * @brief Start a stream for one entity.
+ * @param[out] rng Stream to initialize.
+ * @param[in] seed Master seed.
+ * @param[in] kind What the stream belongs to.
+ * @param[in] id Entity ID.
+ */
+void rng_seed(struct Rng* rng, uint64_t seed, enum RngStreamKind kind, int64_t id);
+
+/**
+ * @brief Next 64 random bits of a stream.
+ * @param[in,out] rng Stream to advance.
+ * @return Uniformly distributed 64-bit value.
+ */
+uint64_t rng_next(struct Rng* rng);
+
+/**
+ * @brief Unbiased random integer in a range (Lemire's multiply-and-reject).
+ * @param[in,out] rng Stream to advance.
+ * @param[in] lower_inclusive Minimum value (inclusive).
+ * @param[in] upper_exclusive Maximum value (exclusive).
+ * @return Random number in [lower_inclusive, upper_exclusive); lower_inclusive for an empty range.
+ */
+int rng_range(struct Rng* rng, int lower_inclusive, int upper_exclusive);
+
+#endif // RNG_H
@@ -0,0 +1,370 @@
+#include <stdlib.h>
+#include "soa.h"
+#include "helpers.h"
+#include "logsink.h"
+#include "console.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define SOA_X86 1
+#endif
+
+// ---- Kernels ----
+#ifndef SOA_X86
+static int check_exits_scalar(struct HunterSoA* soa) {
+    int marked = 0;
+    for (int i = 0; i < soa->capacity; i++) {
+        if (soa->status[i] != SOA_ACTIVE) continue;
+        if (soa->fear[i] >= HUNTER_FEAR_MAX) {
+            soa->status[i] = LR_AFRAID | SOA_PENDING;
+            marked++;
+        } else if (soa->boredom[i] >= ENTITY_BOREDOM_MAX) {
+            soa->status[i] = LR_BORED | SOA_PENDING;
+            marked++;
+        }
+    }
+    return marked;
+}
+
+static void update_fear_scalar(struct HunterSoA* soa, int32_t ghost_room) {
+    for (int i = 0; i < soa->capacity; i++) {
+        if (soa->status[i] != SOA_ACTIVE) continue;
+        if (soa->room[i] == ghost_room) {
+            soa->boredom[i] = 0;
+            soa->fear[i]++;
+        } else {
+            soa->boredom[i]++;
+        }
+    }
+}
+#else
+
+// SSE2 has no blend: pick a where mask is set, b elsewhere
+static inline __m128i select_sse2(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static int check_exits_sse2(struct HunterSoA* soa) {
+    const __m128i active_value = _mm_set1_epi32(SOA_ACTIVE);
+    const __m128i fear_limit = _mm_set1_epi32(HUNTER_FEAR_MAX - 1);
+    const __m128i boredom_limit = _mm_set1_epi32(ENTITY_BOREDOM_MAX - 1);
+    const __m128i afraid_value = _mm_set1_epi32(LR_AFRAID | SOA_PENDING);
+    const __m128i bored_value = _mm_set1_epi32(LR_BORED | SOA_PENDING);
+    int marked = 0;
+
+    for (int i = 0; i < soa->capacity; i += 4) {
+        __m128i status = _mm_load_si128((const __m128i*)(soa->status + i));
+        __m128i fear = _mm_load_si128((const __m128i*)(soa->fear + i));
+        __m128i boredom = _mm_load_si128((const __m128i*)(soa->boredom + i));
+
+        __m128i active = _mm_cmpeq_epi32(status, active_value);
+        __m128i afraid = _mm_and_si128(active, _mm_cmpgt_epi32(fear, fear_limit));
+        __m128i bored = _mm_andnot_si128(afraid, _mm_and_si128(active, _mm_cmpgt_epi32(boredom, boredom_limit)));
+
+        status = select_sse2(afraid, afraid_value, status);
+        status = select_sse2(bored, bored_value, status);
+        _mm_store_si128((__m128i*)(soa->status + i), status);
+
+        marked += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(afraid, bored))));
+    }
+    return marked;
+}
+
+static void update_fear_sse2(struct HunterSoA* soa, int32_t ghost_room) {
+    const __m128i active_value = _mm_set1_epi32(SOA_ACTIVE);
+    const __m128i lair = _mm_set1_epi32(ghost_room);
+
+    for (int i = 0; i < soa->capacity; i += 4) {
+        __m128i status = _mm_load_si128((const __m128i*)(soa->status + i));
+        __m128i room = _mm_load_si128((const __m128i*)(soa->room + i));
+        __m128i fear = _mm_load_si128((const __m128i*)(soa->fear + i));
+        __m128i boredom = _mm_load_si128((const __m128i*)(soa->boredom + i));
+
+        // Masks are -1 per set lane, so subtracting them counts up
+        __m128i active = _mm_cmpeq_epi32(status, active_value);
+        __m128i here = _mm_and_si128(active, _mm_cmpeq_epi32(room, lair));
+        fear = _mm_sub_epi32(fear, here);
+        boredom = _mm_andnot_si128(here, _mm_sub_epi32(boredom, active));
+
+        _mm_store_si128((__m128i*)(soa->fear + i), fear);
+        _mm_store_si128((__m128i*)(soa->boredom + i), boredom);
+    }
+}
+
+__attribute__((target("avx2")))
+static int check_exits_avx2(struct HunterSoA* soa) {
+    const __m256i active_value = _mm256_set1_epi32(SOA_ACTIVE);
+    const __m256i fear_limit = _mm256_set1_epi32(HUNTER_FEAR_MAX - 1);
+    const __m256i boredom_limit = _mm256_set1_epi32(ENTITY_BOREDOM_MAX - 1);
+    const __m256i afraid_value = _mm256_set1_epi32(LR_AFRAID | SOA_PENDING);
+    const __m256i bored_value = _mm256_set1_epi32(LR_BORED | SOA_PENDING);
+    int marked = 0;
+
+    for (int i = 0; i < soa->capacity; i += 8) {
+        __m256i status = _mm256_load_si256((const __m256i*)(soa->status + i));
+        __m256i fear = _mm256_load_si256((const __m256i*)(soa->fear + i));
+        __m256i boredom = _mm256_load_si256((const __m256i*)(soa->boredom + i));
+
+        __m256i active = _mm256_cmpeq_epi32(status, active_value);
+        __m256i afraid = _mm256_and_si256(active, _mm256_cmpgt_epi32(fear, fear_limit));
+        __m256i bored = _mm256_andnot_si256(afraid, _mm256_and_si256(active, _mm256_cmpgt_epi32(boredom, boredom_limit)));
+
+        status = _mm256_blendv_epi8(status, afraid_value, afraid);
+        status = _mm256_blendv_epi8(status, bored_value, bored);
+        _mm256_store_si256((__m256i*)(soa->status + i), status);
+
+        marked += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(afraid, bored))));
+    }
+    return marked;
+}
+
+__attribute__((target("avx2")))
+static void update_fear_avx2(struct HunterSoA* soa, int32_t ghost_room) {
+    const __m256i active_value = _mm256_set1_epi32(SOA_ACTIVE);
+    const __m256i lair = _mm256_set1_epi32(ghost_room);
+
+    for (int i = 0; i < soa->capacity; i += 8) {
+        __m256i status = _mm256_load_si256((const __m256i*)(soa->status + i));
+        __m256i room = _mm256_load_si256((const __m256i*)(soa->room + i));
+        __m256i fear = _mm256_load_si256((const __m256i*)(soa->fear + i));
+        __m256i boredom = _mm256_load_si256((const __m256i*)(soa->boredom + i));
+
+        __m256i active = _mm256_cmpeq_epi32(status, active_value);
+        __m256i here = _mm256_and_si256(active, _mm256_cmpeq_epi32(room, lair));
+        fear = _mm256_sub_epi32(fear, here);
+        boredom = _mm256_andnot_si256(here, _mm256_sub_epi32(boredom, active));
+
+        _mm256_store_si256((__m256i*)(soa->fear + i), fear);
+        _mm256_store_si256((__m256i*)(soa->boredom + i), boredom);
+    }
+}
+#endif
+
+int soa_check_exits(struct HunterSoA* soa) {
+#ifdef SOA_X86
+    if (__builtin_cpu_supports("avx2")) return check_exits_avx2(soa);
+    return check_exits_sse2(soa); // Always present on x86-64
+#else
+    return check_exits_scalar(soa);
+#endif
+}
+
+void soa_update_fear(struct HunterSoA* soa, int32_t ghost_room) {
+#ifdef SOA_X86
+    if (__builtin_cpu_supports("avx2")) {
+        update_fear_avx2(soa, ghost_room);
+        return;
+    }
+    update_fear_sse2(soa, ghost_room);
+#else
+    update_fear_scalar(soa, ghost_room);
+#endif
+}
+
+// ---- Store ----
+static int32_t* lanes_alloc(int capacity) {
+    int32_t* lanes = aligned_alloc(32, sizeof(int32_t) * (capacity > 0 ? capacity : SOA_LANES));
+    for (int i = 0; i < capacity; i++) lanes[i] = 0;
+    return lanes;
+}
+
+// Copy the hot fields of every hunter into the arrays
+static void soa_load(struct HunterSoA* soa, const struct House* house) {
+    soa->count = house->hunterCount;
+    soa->capacity = (house->hunterCount + SOA_LANES - 1) / SOA_LANES * SOA_LANES;
+    soa->room = lanes_alloc(soa->capacity);
+    soa->fear = lanes_alloc(soa->capacity);
+    soa->boredom = lanes_alloc(soa->capacity);
+    soa->device = lanes_alloc(soa->capacity);
+    soa->status = lanes_alloc(soa->capacity);
+    soa->moves = lanes_alloc(soa->capacity);
+    soa->id = lanes_alloc(soa->capacity);
+    soa->rng = malloc(sizeof(struct Rng) * (soa->count > 0 ? soa->count : 1));
+
+    for (int i = 0; i < soa->capacity; i++) {
+        if (i >= soa->count) {
+            soa->status[i] = SOA_PADDING;
+            continue;
+        }
+        const struct Hunter* hunt = &house->hunter[i];
+        soa->room[i] = hunt->current ? hunt->current->index : -1;
+        soa->fear[i] = hunt->fear;
+        soa->boredom[i] = hunt->boredom;
+        soa->device[i] = hunt->currentDevice;
+        soa->status[i] = hunt->exitHouse ? (int32_t)hunt->whyExit : SOA_ACTIVE;
+        soa->moves[i] = hunt->moves;
+        soa->id[i] = hunt->id;
+        soa->rng[i] = hunt->rng;
+    }
+}
+
+// Write the results back where the summary and batch statistics read them
+static void soa_store(const struct HunterSoA* soa, struct House* house) {
+    for (int i = 0; i < soa->count; i++) {
+        struct Hunter* hunt = &house->hunter[i];
+        hunt->current = soa->room[i] >= 0 ? &house->rooms[soa->room[i]] : NULL;
+        hunt->fear = soa->fear[i];
+        hunt->boredom = soa->boredom[i];
+        hunt->moves = soa->moves[i];
+        hunt->rng = soa->rng[i];
+        hunt->exitHouse = (soa->status[i] != SOA_ACTIVE);
+        if (hunt->exitHouse) hunt->whyExit = (enum LogReason)soa->status[i];
+    }
+}
+
+static void soa_free(struct HunterSoA* soa) {
+    free(soa->room);
+    free(soa->fear);
+    free(soa->boredom);
+    free(soa->device);
+    free(soa->status);
+    free(soa->moves);
+    free(soa->id);
+    free(soa->rng);
+}
+
+// ---- Tick phases ----
+// Take the evidence of each hunter's room into the case file
+static void soa_collect(struct HunterSoA* soa, struct House* house) {
+    struct CaseFile* file = &house->fileCase;
+
+    for (int i = 0; i < soa->count; i++) {
+        if (soa->status[i] != SOA_ACTIVE) continue;
+
+        struct Room* room = &house->rooms[soa->room[i]];
+        if (atomic_load_explicit(&room->evidence, memory_order_relaxed) == 0) continue;
+
+        EvidenceByte mask = atomic_exchange_explicit(&room->evidence, 0, memory_order_relaxed);
+        log_evidence(soa->id[i], soa->boredom[i], soa->fear[i], room->index, (enum EvidenceType)mask);
+
+        casefile_add(file, mask);
+    }
+}
+
+// Log the exits soa_check_exits() marked; returns how many hunters left
+static int soa_log_exits(struct HunterSoA* soa) {
+    int left = 0;
+    for (int i = 0; i < soa->count; i++) {
+        if (soa->status[i] < 0 || !(soa->status[i] & SOA_PENDING)) continue;
+
+        enum LogReason reason = (enum LogReason)(soa->status[i] & ~SOA_PENDING);
+        log_exit(soa->id[i], soa->boredom[i], soa->fear[i], soa->room[i], (enum EvidenceType)soa->device[i], reason);
+        soa->status[i] = reason;
+        left++;
+    }
+    return left;
+}
+
+// Case solved: every hunter follows the shortest route back to the van
+static int soa_return_to_van(struct HunterSoA* soa, struct House* house) {
+    int left = 0;
+    for (int i = 0; i < soa->count; i++) {
+        if (soa->status[i] != SOA_ACTIVE) continue;
+
+        enum EvidenceType device = (enum EvidenceType)soa->device[i];
+        log_return_to_van(soa->id[i], soa->boredom[i], soa->fear[i], soa->room[i], device, true);
+
+        int van = house->starting_room->index;
+        struct Room* current = &house->rooms[soa->room[i]];
+        while (current->index != van) {
+            int hop = house->routes.home_hop[current->index];
+            if (hop < 0) break;
+
+            struct Room* to = &house->rooms[hop];
+
+            log_move(soa->id[i], soa->boredom[i], soa->fear[i], current->index, to->index, device);
+            current = to;
+            soa->moves[i]++;
+        }
+        soa->room[i] = current->index;
+
+        log_return_to_van(soa->id[i], soa->boredom[i], soa->fear[i], house->starting_room->index, device, false);
+        soa->status[i] = LR_EVIDENCE;
+        left++;
+    }
+    return left;
+}
+
+// Leave through the exit with a full match, otherwise move to a random neighbour;
+// returns how many hunters left. Room hunter lists are not kept: soa->room is the occupancy.
+static int soa_move(struct HunterSoA* soa, struct House* house) {
+    const struct CaseFile* file = &house->fileCase;
+    enum GhostType type = house->ghost.ghostType;
+    int left = 0;
+
+    for (int i = 0; i < soa->count; i++) {
+        if (soa->status[i] != SOA_ACTIVE) continue;
+
+        struct Room* current = &house->rooms[soa->room[i]];
+        enum EvidenceType device = (enum EvidenceType)soa->device[i];
+
+        if (current->exitRoom) {
+            if ((casefile_collected(file) & type) == type) {
+                log_exit(soa->id[i], soa->boredom[i], soa->fear[i], current->index, device, LR_EVIDENCE);
+                soa->room[i] = -1;
+                soa->status[i] = LR_EVIDENCE;
+                left++;
+                continue;
+            }
+        }
+
+        if (current->connectionCount > 0) {
+            struct Room* next = &house->rooms[current->connected[rng_range(&soa->rng[i], 0, current->connectionCount)]];
+
+            log_move(soa->id[i], soa->boredom[i], soa->fear[i], current->index, next->index, device);
+            soa->room[i] = next->index;
+            soa->moves[i]++;
+        }
+    }
+    return left;
+}
+
+// ---- Engine ----
+// One turn of every active hunter, in the phase order of hunter_step()
+static void soa_hunters_tick(struct HunterSoA* soa, struct House* house, int* remaining) {
+    if (*remaining == 0) return;
+
+    soa_collect(soa, house);
+
+    if (soa_check_exits(soa) > 0) *remaining -= soa_log_exits(soa);
+    if (*remaining == 0) return;
+
+    if (casefile_solved(&house->fileCase)) {
+        *remaining -= soa_return_to_van(soa, house);
+        return;
+    }
+
+    const struct Room* lair = house->ghost.hidden;
+    soa_update_fear(soa, lair ? lair->index : -1);
+    *remaining -= soa_move(soa, house);
+}
+
+void soa_simulate(struct House* house) {
+    struct HunterSoA soa;
+    soa_load(&soa, house);
+
+    struct Rng order;
+    rng_seed(&order, house->seed, RNG_STREAM_SCHEDULER, 0);
+
+    struct Ghost* ghost = &house->ghost;
+    bool ghost_active = !ghost->exitSim;
+    int remaining = 0;
+    for (int i = 0; i < soa.count; i++) {
+        if (soa.status[i] == SOA_ACTIVE) remaining++;
+    }
+
+    while (ghost_active || remaining > 0) {
+        // The ghost acts before or after the hunters; a fixed order would keep
+        // walkers on a bipartite map from ever sharing a room
+        bool ghost_first = rng_range(&order, 0, 2) == 0;
+        if (ghost_active && ghost_first) ghost_active = ghost_step(ghost);
+        soa_hunters_tick(&soa, house, &remaining);
+        if (ghost_active && !ghost_first) ghost_active = ghost_step(ghost);
+    }
+
+    soa_store(&soa, house);
+    soa_free(&soa);
+
+    logsink_flush_thread(); // Every agent logged from this thread
+    console_flush_thread();
+}
@@ -0,0 +1,54 @@
+#ifndef SOA_H
+#define SOA_H
+
+#include <stdint.h>
+#include "defs.h"
+
+#define SOA_LANES 8 // Arrays are padded to a multiple of the widest vector (AVX2, 8 x int32)
+
+#define SOA_ACTIVE  -1 // Hunter still in the house
+#define SOA_PADDING -2 // Unused lane past the last hunter
+#define SOA_PENDING 0x10 // Set with an exit reason until the exit has been logged
+
+// Hot hunter state as parallel arrays; names stay in house->hunter
+struct HunterSoA {
+    int count; // Hunters in use
+    int capacity; // Allocated lanes, a multiple of SOA_LANES
+    int32_t* room; // Room index, -1 once gone
+    int32_t* fear; // Fear counter
+    int32_t* boredom; // Boredom counter
+    int32_t* device; // Device held (enum EvidenceType)
+    int32_t* status; // SOA_ACTIVE, SOA_PADDING or the enum LogReason of the exit
+    int32_t* moves; // Rooms moved through this run
+    int32_t* id; // Hunter ID, copied for the logs
+    struct Rng* rng; // Random streams
+};
+
+/**
+ * @brief Mark hunters whose fear or boredom reached the limit as leaving.
+ * @param[in,out] soa Hunter arrays; lanes leaving get their reason | SOA_PENDING.
+ * @return Number of hunters marked.
+ */
+int soa_check_exits(struct HunterSoA* soa);
+
+/**
+ * @brief Raise fear where the ghost is and boredom everywhere else.
+ * @param[in,out] soa Hunter arrays; only active lanes change.
+ * @param[in] ghost_room Room index holding the ghost, -1 for none.
+ */
+void soa_update_fear(struct HunterSoA* soa, int32_t ghost_room);
+
+/**
+ * @brief Run every agent of a house in lockstep ticks on the calling thread.
+ * @param[in,out] house Populated house with its ghost and hunters in place.
+ *
+ * Each tick every active hunter takes one turn and the ghost acts before or
+ * after them, as drawn from the scheduler stream. Evidence is collected room
+ * by room, while the fear/boredom exits and updates run over all hunters at
+ * once with SIMD kernels (AVX2 or SSE2, scalar elsewhere). No locks are taken
+ * and a seed always replays the same run. Results are written back to
+ * house->hunter.
+ */
+void soa_simulate(struct House* house);
+
+#endif // SOA_H